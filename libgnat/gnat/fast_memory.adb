@@ -0,0 +1,187 @@
+with Ada.Unchecked_Conversion;
+with System.Machine_Code; use System.Machine_Code;
+
+package body Fast_Memory is
+
+   use Interfaces;
+
+   LF : constant Character := ASCII.LF;
+
+   function To_Unsigned_32 is new Ada.Unchecked_Conversion
+     (System.Address, Unsigned_32);
+
+   function To_Address is new Ada.Unchecked_Conversion
+     (Unsigned_32, System.Address);
+
+   procedure Copy_Byte (D : Unsigned_32; S : Unsigned_32)
+      with Inline_Always;
+
+   procedure Copy_Word (D : Unsigned_32; S : Unsigned_32)
+      with Inline_Always;
+
+   ---------------
+   -- Copy_Byte --
+   ---------------
+
+   procedure Copy_Byte (D : Unsigned_32; S : Unsigned_32) is
+      DB : Unsigned_8 with Import, Address => To_Address (D);
+      SB : Unsigned_8 with Import, Address => To_Address (S);
+   begin
+      DB := SB;
+   end Copy_Byte;
+
+   ---------------
+   -- Copy_Word --
+   ---------------
+
+   procedure Copy_Word (D : Unsigned_32; S : Unsigned_32) is
+      DW : Unsigned_32 with Import, Address => To_Address (D);
+      SW : Unsigned_32 with Import, Address => To_Address (S);
+   begin
+      DW := SW;
+   end Copy_Word;
+
+   ----------
+   -- Copy --
+   ----------
+
+   procedure Copy
+     (Dest : System.Address;
+      Src  : System.Address;
+      Size : Interfaces.Unsigned_32)
+   is
+      D      : Unsigned_32 := To_Unsigned_32 (Dest);
+      S      : Unsigned_32 := To_Unsigned_32 (Src);
+      N      : Unsigned_32 := Size;
+      Blocks : Unsigned_32;
+   begin
+      --  Word transfers are only possible if both buffers have the same
+      --  alignment. Otherwise, the copy is done bytewise.
+
+      if ((D xor S) and 3) = 0 then
+
+         --  Unaligned head
+
+         while N > 0 and then (D and 3) /= 0 loop
+            Copy_Byte (D, S);
+            D := D + 1;
+            S := S + 1;
+            N := N - 1;
+         end loop;
+
+         --  16 bytes blocks, with a LDM/STM pair per block
+
+         Blocks := N and not 15;
+
+         if Blocks > 0 then
+            Asm ("1:"                              & LF &
+                 "ldmia %1!, {r3, r4, r5, r12}"     & LF &
+                 "stmia %0!, {r3, r4, r5, r12}"     & LF &
+                 "subs  %2, %2, #16"                & LF &
+                 "bne   1b",
+                 Outputs  => (Unsigned_32'Asm_Output ("=r", D),
+                              Unsigned_32'Asm_Output ("=r", S),
+                              Unsigned_32'Asm_Output ("=r", Blocks)),
+                 Inputs   => (Unsigned_32'Asm_Input ("0", D),
+                              Unsigned_32'Asm_Input ("1", S),
+                              Unsigned_32'Asm_Input ("2", Blocks)),
+                 Clobber  => "r3, r4, r5, r12, cc, memory",
+                 Volatile => True);
+            N := N and 15;
+         end if;
+
+         --  Remaining words
+
+         while N >= 4 loop
+            Copy_Word (D, S);
+            D := D + 4;
+            S := S + 4;
+            N := N - 4;
+         end loop;
+      end if;
+
+      --  Tail (or whole unaligned buffer)
+
+      while N > 0 loop
+         Copy_Byte (D, S);
+         D := D + 1;
+         S := S + 1;
+         N := N - 1;
+      end loop;
+   end Copy;
+
+   ----------
+   -- Fill --
+   ----------
+
+   procedure Fill
+     (Dest  : System.Address;
+      Value : Interfaces.Unsigned_8;
+      Size  : Interfaces.Unsigned_32)
+   is
+      Pattern : constant Unsigned_32 := Unsigned_32 (Value) * 16#0101_0101#;
+      D       : Unsigned_32 := To_Unsigned_32 (Dest);
+      N       : Unsigned_32 := Size;
+      Blocks  : Unsigned_32;
+   begin
+      --  Unaligned head
+
+      while N > 0 and then (D and 3) /= 0 loop
+         declare
+            DB : Unsigned_8 with Import, Address => To_Address (D);
+         begin
+            DB := Value;
+         end;
+         D := D + 1;
+         N := N - 1;
+      end loop;
+
+      --  16 bytes blocks, unrolled with a single STM per block
+
+      Blocks := N and not 15;
+
+      if Blocks > 0 then
+         Asm ("mov   r3, %4"                       & LF &
+              "mov   r4, %4"                       & LF &
+              "mov   r5, %4"                       & LF &
+              "mov   r12, %4"                      & LF &
+              "1:"                                 & LF &
+              "stmia %0!, {r3, r4, r5, r12}"       & LF &
+              "subs  %1, %1, #16"                  & LF &
+              "bne   1b",
+              Outputs  => (Unsigned_32'Asm_Output ("=r", D),
+                           Unsigned_32'Asm_Output ("=r", Blocks)),
+              Inputs   => (Unsigned_32'Asm_Input ("0", D),
+                           Unsigned_32'Asm_Input ("1", Blocks),
+                           Unsigned_32'Asm_Input ("r", Pattern)),
+              Clobber  => "r3, r4, r5, r12, cc, memory",
+              Volatile => True);
+         N := N and 15;
+      end if;
+
+      --  Remaining words
+
+      while N >= 4 loop
+         declare
+            DW : Unsigned_32 with Import, Address => To_Address (D);
+         begin
+            DW := Pattern;
+         end;
+         D := D + 4;
+         N := N - 4;
+      end loop;
+
+      --  Tail
+
+      while N > 0 loop
+         declare
+            DB : Unsigned_8 with Import, Address => To_Address (D);
+         begin
+            DB := Value;
+         end;
+         D := D + 1;
+         N := N - 1;
+      end loop;
+   end Fill;
+
+end Fast_Memory;
@@ -50,7 +50,9 @@ typedef enum {
   /** FIFO mode: using FIFO indirection of address pointers */
 	DMA_FIFO_MODE     = 1,
   /** Circular mode: using a circular buffer */
-	DMA_CIRCULAR_MODE = 2
+	DMA_CIRCULAR_MODE = 2,
+  /** Double buffer mode: switching between two buffers (circular) */
+	DMA_DOUBLE_BUFFER_MODE = 3
 } dma_mode_t;
 
 typedef enum {
@@ -140,8 +142,25 @@ typedef struct {
     bool dev_inc;           /**< Increment for device, with the same behavior as the mem_inc, but for the device. Typically set to 0 when the DMA read (or write) to (from) a register */
     dma_burst_t mem_burst;  /**< Memory burst size */
     dma_burst_t dev_burst;  /**< Device burst size */
+    physaddr_t mem1_addr;   /**< Second memory buffer (double buffer mode only), same size as the first one */
+    bool half_transfer;     /**< Also call the handler when half of the buffer is transferred (circular and double buffer modes only). Reconfigured with the mode */
 } dma_t;
 
+/** Maximum number of segments of a DMA scatter-gather chain */
+#define MAX_DMA_SEGMENTS 8
+
+/**
+** \brief DMA scatter-gather chain segment
+**
+** Memory side buffer (source for memory to peripheral transfers,
+** destination for peripheral to memory transfers) of one of the transfers
+** of a chain. See sys_cfg(CFG_DMA_CHAIN).
+*/
+typedef struct {
+    physaddr_t addr;    /**< Segment base address */
+    uint16_t   size;    /**< Segment size in bytes */
+} dma_segment_t;
+
 
 /**
 ** \brief DMA shared memory access mode
@@ -186,6 +205,9 @@ enum dma_status {
     DMA_TRANSFER_ERROR    = (0x1 << 3),
     DMA_HALF_TRANSFER     = (0x1 << 4),
     DMA_TRANSFER          = (0x1 << 5),
+    /* Double buffer mode: the DMA is now using the second (mem1) buffer,
+     * the first one can be processed */
+    DMA_CURRENT_TARGET    = (0x1 << 6),
 };
 
 
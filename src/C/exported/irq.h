@@ -113,6 +113,22 @@ typedef enum {
     IRQ_ISR_WITHOUT_MAINTHREAD = 2,
 } dev_irq_isr_scheduling_t;
 
+/**
+ ** \brief Interrupt coalescing
+ **
+ ** When coalescing is requested, an interrupt raised while a previous one
+ ** is still waiting for its ISR to be executed is merged with it: the
+ ** posthook status values are ORed, the last posthook data value is kept
+ ** and the ISR is executed only once.
+ ** The ISR irq argument then holds the IRQ number in its lower 16 bits and
+ ** the number of merged interrupts in its upper 16 bits.
+ ** Requires the kernel to be built with KERNEL_ISR_COALESCING.
+ */
+typedef enum {
+    IRQ_ISR_NO_COALESCING = 0,
+    IRQ_ISR_COALESCING    = 1,
+} dev_irq_isr_coalescing_t;
+
 /**
  *  \brief This is the IRQ handler informational structure for user drivers
  *
@@ -160,6 +176,15 @@ typedef struct {
      *   have been able to do the same in its ISR).
      */
     dev_irq_ph_t posthook;
+
+#ifdef CONFIG_KERNEL_ISR_COALESCING
+    /**< Interrupt coalescing, see dev_irq_isr_coalescing_t description.
+     *   This field only exists when the kernel is built with
+     *   KERNEL_ISR_COALESCING, the structure layout being otherwise left
+     *   unchanged.
+     */
+    dev_irq_isr_coalescing_t coalescing;
+#endif
 } dev_irq_info_t;
 
 #endif
@@ -0,0 +1,55 @@
+/* \file latency.h
+ *
+ * Copyright 2018 The wookey project team <wookey@ssi.gouv.fr>
+ *   - Ryad     Benadjila
+ *   - Arnauld  Michelizza
+ *   - Mathieu  Renard
+ *   - Philippe Thierry
+ *   - Philippe Trebuchet
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ *
+ */
+#ifndef KERNEL_LATENCY_H_
+#define KERNEL_LATENCY_H_
+
+/*
+ * Remember to include libstd types.h header for stdint support
+ */
+
+/*
+ * Interrupts latency statistics (see sys_isr_latency). Latencies are
+ * given in CPU cycles.
+ */
+typedef enum {
+    LAT_POSTHOOK,   /* IRQ entry -> posthook done */
+    LAT_QUEUED,     /* posthook done -> dispatched by the softirq */
+    LAT_SCHEDULED,  /* dispatched -> ISR thread first run */
+    LAT_EXECUTED,   /* ISR thread first run -> ISR done */
+    LAT_TOTAL,      /* IRQ entry -> ISR done */
+    LAT_STAGES_NUM
+} latency_stage_t;
+
+/* Bucket n counts latencies from 2^n to 2^(n+1)-1 cycles */
+#define LATENCY_HIST_BUCKETS 24
+
+typedef struct {
+    uint16_t hist[LATENCY_HIST_BUCKETS];
+    uint32_t max;
+} latency_stage_stats_t;
+
+typedef struct {
+    latency_stage_stats_t stage[LAT_STAGES_NUM];
+} latency_stats_t;
+
+#endif/*!KERNEL_LATENCY_H_*/
@@ -0,0 +1,46 @@
+/* \file memusage.h
+ *
+ * Copyright 2018 The wookey project team <wookey@ssi.gouv.fr>
+ *   - Ryad     Benadjila
+ *   - Arnauld  Michelizza
+ *   - Mathieu  Renard
+ *   - Philippe Thierry
+ *   - Philippe Trebuchet
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ *
+ */
+#ifndef KERNEL_MEMUSAGE_H_
+#define KERNEL_MEMUSAGE_H_
+
+/*
+ * Remember to include libstd types.h header for stdint support
+ */
+
+/*
+ * Task RAM usage (see sys_mem_usage). Sizes are given in bytes. Stacks
+ * and heap usage are high-water marks.
+ */
+typedef struct {
+    uint32_t stack_size;
+    uint32_t stack_used;
+    uint32_t isr_stack_size;
+    uint32_t isr_stack_used;
+    uint32_t data_size;
+    uint32_t bss_size;
+    uint32_t heap_size;
+    uint32_t heap_used;
+    uint32_t free_space;   /* unused space at the end of the task slots */
+} mem_usage_t;
+
+#endif/*!KERNEL_MEMUSAGE_H_*/
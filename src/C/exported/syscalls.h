@@ -57,7 +57,16 @@ typedef enum {
     SVC_LOCK_ENTER,
     SVC_LOCK_EXIT,
     SVC_PANIC,
-    SVC_ALARM
+    SVC_ALARM,
+    SVC_ISR_LATENCY,
+    SVC_DMA_CHAIN,
+    SVC_REGISTER_DMA_BUFFER,
+    SVC_DMA_RECONF_BUFFER,
+    SVC_GPIO_EXTI_TIMESTAMPS,
+    SVC_GPIO_SET_MASKED,
+    SVC_GPIO_GET_MASKED,
+    SVC_MEM_USAGE,
+    SVC_ALARM_HR
 } e_svc_type;
 
 /**
@@ -150,7 +159,21 @@ typedef enum {
     /** unmap a device set as DEV_MAP_VOLUNTARY */
     CFG_DEV_UNMAP,
     /** Release a device */
-    CFG_DEV_RELEASE
+    CFG_DEV_RELEASE,
+    /** Set the scatter-gather chain of one of the task's predeclared DMA
+     * streams */
+    CFG_DMA_CHAIN,
+    /** Check a DMA buffer once and get a handle on it */
+    CFG_DMA_REGISTER_BUFFER,
+    /** Set the memory buffer of one of the task's DMA streams to a part
+     * of a registered DMA buffer */
+    CFG_DMA_RECONF_BUFFER,
+    /** Read the timestamps of the EXTI events of a GPIO */
+    CFG_GPIO_EXTI_TIMESTAMPS,
+    /** Set several output GPIOs of a port in a single operation */
+    CFG_GPIO_SET_MASKED,
+    /** Get several input GPIOs of a port in a single operation */
+    CFG_GPIO_GET_MASKED
 } e_cfg_type;
 
 //[PTH] TODO: differentiate a synchronous send/recv and an asynchronous (with loss) one
@@ -80,6 +80,19 @@ is
    end REV;
 
 
+   function CTZ (value : unsigned_32) return unsigned_32
+   is
+      count : unsigned_32;
+   begin
+      system.machine_code.asm
+        ("rbit %0, %1" & ascii.lf &
+         "clz  %0, %0",
+         inputs   => unsigned_32'asm_input ("r", value),
+         outputs  => unsigned_32'asm_output ("=r", count));
+      return count;
+   end CTZ;
+
+
    procedure BKPT
    is
    begin
@@ -0,0 +1 @@
+../stm32f439/soc-tim.adb
\ No newline at end of file
@@ -99,10 +99,24 @@ is
    end get_interrupt_status;
 
 
+   function get_current_target
+     (dma_id  : in  soc.dma.t_dma_periph_index;
+      stream  : in  soc.dma.t_stream_index)
+      return soc.dma.t_current_target
+   is
+   begin
+      case dma_id is
+         when ID_DMA1 => return soc.dma.DMA1.streams(stream).CR.CT;
+         when ID_DMA2 => return soc.dma.DMA2.streams(stream).CR.CT;
+      end case;
+   end get_current_target;
+
+
    procedure configure_stream
      (dma_id      : in  soc.dma.t_dma_periph_index;
       stream      : in  soc.dma.t_stream_index;
-      user_config : in  t_dma_config)
+      user_config : in  t_dma_config;
+      success     : out boolean)
    is
       controller  : t_dma_periph_access;
       size        : unsigned_16; -- Number of data items to transfer
@@ -138,6 +152,11 @@ is
             controller.streams(stream).M0AR  := user_config.out_addr;
       end case;
 
+      -- Second memory buffer
+      if user_config.mode = DOUBLE_BUFFER_MODE then
+         controller.streams(stream).M1AR  := user_config.mem1_addr;
+      end if;
+
       -- Channel selection
       controller.streams(stream).CR.CHSEL    := user_config.channel;
 
@@ -154,7 +173,8 @@ is
       controller.streams(stream).CR.CT       := MEMORY_0;
 
       -- Double buffer mode
-      controller.streams(stream).CR.DBM      := false;
+      controller.streams(stream).CR.DBM      :=
+         user_config.mode = DOUBLE_BUFFER_MODE;
 
       -- Peripheral incr. size (PSIZE or WORD)
       controller.streams(stream).CR.PINCOS   := INCREMENT_PSIZE;
@@ -210,12 +230,18 @@ is
       -- Enable interrupts
       case user_config.mode is
          when DIRECT_MODE     =>
+            controller.streams(stream).CR.CIRC              := false;
+            controller.streams(stream).CR.DBM               := false;
+            controller.streams(stream).CR.HALF_COMPLETE     := false;
             controller.streams(stream).FCR.FIFO_ERROR       := false;
             controller.streams(stream).CR.DIRECT_MODE_ERROR := true;
             controller.streams(stream).CR.TRANSFER_ERROR    := true;
             controller.streams(stream).CR.TRANSFER_COMPLETE := true;
 
          when FIFO_MODE       =>
+            controller.streams(stream).CR.CIRC              := false;
+            controller.streams(stream).CR.DBM               := false;
+            controller.streams(stream).CR.HALF_COMPLETE     := false;
             controller.streams(stream).FCR.DMDIS            := true; -- Disable direct mode
             controller.streams(stream).FCR.FIFO_ERROR       := true;
             controller.streams(stream).FCR.FTH              := FIFO_FULL;
@@ -224,15 +250,37 @@ is
 
          when CIRCULAR_MODE   =>
             if user_config.transfer_dir = MEMORY_TO_MEMORY then
-               raise program_error; -- Not implemented
+               success := false; -- Not implemented
+               return;
             end if;
             controller.streams(stream).FCR.DMDIS            := true; -- Disable direct mode
             controller.streams(stream).FCR.FIFO_ERROR       := false;
             controller.streams(stream).CR.CIRC              := true; -- Enable circular mode
+            controller.streams(stream).CR.DBM               := false;
+            controller.streams(stream).CR.HALF_COMPLETE     :=
+               user_config.half_transfer;
+            controller.streams(stream).CR.TRANSFER_ERROR    := true;
+            controller.streams(stream).CR.TRANSFER_COMPLETE := true;
+
+         when DOUBLE_BUFFER_MODE =>
+            if user_config.transfer_dir = MEMORY_TO_MEMORY then
+               success := false; -- Not supported by the hardware
+               return;
+            end if;
+            controller.streams(stream).FCR.DMDIS            := true; -- Disable direct mode
+            controller.streams(stream).FCR.FIFO_ERROR       := false;
+            -- Circular mode is implied by the double buffer mode
+            controller.streams(stream).CR.CIRC              := true;
+            controller.streams(stream).CR.DBM               := true;
+            controller.streams(stream).CR.CT                := MEMORY_0;
+            controller.streams(stream).CR.HALF_COMPLETE     :=
+               user_config.half_transfer;
             controller.streams(stream).CR.TRANSFER_ERROR    := true;
             controller.streams(stream).CR.TRANSFER_COMPLETE := true;
       end case;
 
+      success := true;
+
    end configure_stream;
 
 
@@ -240,7 +288,8 @@ is
      (dma_id      : in  soc.dma.t_dma_periph_index;
       stream      : in  soc.dma.t_stream_index;
       user_config : in  t_dma_config;
-      to_configure: in  t_config_mask)
+      to_configure: in  t_config_mask;
+      success     : out boolean)
    is
       controller  : t_dma_periph_access;
       size        : unsigned_16; -- Number of data items to transfer
@@ -277,6 +326,15 @@ is
          end case;
       end if;
 
+      -- Second memory buffer, also programmed when switching to the
+      -- double buffer mode
+      if (to_configure.buffer_in or to_configure.buffer_out or
+          to_configure.mode) and
+         user_config.mode = DOUBLE_BUFFER_MODE
+      then
+         controller.streams(stream).M1AR  := user_config.mem1_addr;
+      end if;
+
       -- Number of data items to transfer
       if user_config.flow_controller = DMA_FLOW_CONTROLLER then
          -- In direct mode, item size in the DMA bufsize register is
@@ -312,12 +370,18 @@ is
       if to_configure.mode then
          case user_config.mode is
             when DIRECT_MODE     =>
+               controller.streams(stream).CR.CIRC              := false;
+               controller.streams(stream).CR.DBM               := false;
+               controller.streams(stream).CR.HALF_COMPLETE     := false;
                controller.streams(stream).FCR.FIFO_ERROR       := false;
                controller.streams(stream).CR.DIRECT_MODE_ERROR := true;
                controller.streams(stream).CR.TRANSFER_ERROR    := true;
                controller.streams(stream).CR.TRANSFER_COMPLETE := true;
 
             when FIFO_MODE       =>
+               controller.streams(stream).CR.CIRC              := false;
+               controller.streams(stream).CR.DBM               := false;
+               controller.streams(stream).CR.HALF_COMPLETE     := false;
                controller.streams(stream).FCR.DMDIS            := true; -- Disable direct mode
 
                controller.streams(stream).FCR.FIFO_ERROR       := true;
@@ -327,17 +391,39 @@ is
 
             when CIRCULAR_MODE   =>
                if user_config.transfer_dir = MEMORY_TO_MEMORY then
-                  raise program_error; -- Not implemented
+                  success := false; -- Not implemented
+                  return;
                end if;
                controller.streams(stream).FCR.DMDIS            := true; -- Disable direct mode
                controller.streams(stream).FCR.FIFO_ERROR       := false;
                controller.streams(stream).CR.CIRC              := true; -- Enable circular mode
+               controller.streams(stream).CR.DBM               := false;
+               controller.streams(stream).CR.HALF_COMPLETE     :=
+                  user_config.half_transfer;
+               controller.streams(stream).CR.TRANSFER_ERROR    := true;
+               controller.streams(stream).CR.TRANSFER_COMPLETE := true;
+
+            when DOUBLE_BUFFER_MODE =>
+               if user_config.transfer_dir = MEMORY_TO_MEMORY then
+                  success := false; -- Not supported by the hardware
+                  return;
+               end if;
+               controller.streams(stream).FCR.DMDIS            := true; -- Disable direct mode
+               controller.streams(stream).FCR.FIFO_ERROR       := false;
+               -- Circular mode is implied by the double buffer mode
+               controller.streams(stream).CR.CIRC              := true;
+               controller.streams(stream).CR.DBM               := true;
+               controller.streams(stream).CR.CT                := MEMORY_0;
+               controller.streams(stream).CR.HALF_COMPLETE     :=
+                  user_config.half_transfer;
                controller.streams(stream).CR.TRANSFER_ERROR    := true;
                controller.streams(stream).CR.TRANSFER_COMPLETE := true;
 
          end case;
       end if;
 
+      success := true;
+
    end reconfigure_stream;
 
 
@@ -58,6 +58,22 @@ is
    end clear_pending;
 
 
+   function get_pending_lines return unsigned_32
+   is
+   begin
+      return to_unsigned_32 (EXTI.PR);
+   end get_pending_lines;
+
+
+   procedure clear_pending_lines
+     (mask : in unsigned_32)
+   is
+   begin
+      -- Writing '0' has no effect on the pending bits
+      EXTI.PR := to_exti_pr (mask);
+   end clear_pending_lines;
+
+
    procedure enable
      (line : in t_exti_line_index)
    is
@@ -20,6 +20,7 @@
 --
 --
 
+with ada.unchecked_conversion;
 with soc.rcc;
 
 -- About SPARK:
@@ -209,4 +210,41 @@ is
       value := GPIOx(port).all.IDR.pin (pin);
    end read_pin;
 
+
+   function to_pins_bsrr is new ada.unchecked_conversion
+     (unsigned_16, t_pins_bsrr);
+
+   function to_unsigned_16 is new ada.unchecked_conversion
+     (t_pins_idr, unsigned_16);
+
+
+   procedure write_pins
+     (port     : in  t_gpio_port_index;
+      set      : in  unsigned_16;
+      reset    : in  unsigned_16)
+      with
+         refined_global => (in_out => (gpio_a, gpio_b, gpio_c,
+                                       gpio_d, gpio_e, gpio_f,
+                                       gpio_g, gpio_h, gpio_i))
+   is
+   begin
+      -- Pins that are both set and reset are set
+      GPIOx(port).all.BSRR :=
+        (BS => to_pins_bsrr (set),
+         BR => to_pins_bsrr (reset));
+   end write_pins;
+
+
+   procedure read_pins
+     (port     : in  t_gpio_port_index;
+      value    : out unsigned_16)
+      with
+         refined_global => (in_out => (gpio_a, gpio_b, gpio_c,
+                                       gpio_d, gpio_e, gpio_f,
+                                       gpio_g, gpio_h, gpio_i))
+   is
+   begin
+      value := to_unsigned_16 (GPIOx(port).all.IDR.pin);
+   end read_pins;
+
 end soc.gpio;
@@ -27,7 +27,11 @@ package body soc.rng
    with spark_mode => off
 is
 
+   -- Last generated word, for the repetition check. The first generated
+   -- word is never returned, it is only kept as the reference for the
+   -- next one (continuous random number generator test).
    last_random : unsigned_32;
+   first_read  : boolean := true;
 
 
    procedure init
@@ -38,17 +42,13 @@ is
       soc.rcc.enable_clock (soc.devmap.RNG);
       RNG.CR.RNGEN := true;
 
-      loop
-         exit when RNG.SR.DRDY;
-      end loop;
-
-      if RNG.SR.SECS or RNG.SR.CECS then
+      -- Not waiting for the first random word: seed errors are also
+      -- checked on each read
+      if RNG.SR.CECS then
          success := false;
       else
          success := true;
       end if;
-
-      last_random := RNG.DR.RNDATA;
    end init;
 
 
@@ -62,14 +62,61 @@ is
          exit when RNG.SR.DRDY;
       end loop;
 
+      read (rand, success);
+   end random;
+
+
+   procedure read
+     (rand     : out unsigned_32;
+      success  : out boolean)
+   is
+   begin
+
+      if first_read then
+         last_random := RNG.DR.RNDATA;
+         first_read  := false;
+
+         loop
+            exit when RNG.SR.DRDY;
+         end loop;
+      end if;
+
       rand := RNG.DR.RNDATA;
 
-      if rand = last_random or RNG.SR.SECS then
+      if RNG.SR.SECS or rand = last_random then
          success := false;
       else
          success := true;
       end if;
-   end random;
+
+      last_random := rand;
+   end read;
+
+
+   function is_ready return boolean
+   is
+   begin
+      return RNG.SR.DRDY;
+   end is_ready;
+
+
+   procedure set_interrupt
+     (enable   : in  boolean)
+   is
+   begin
+      RNG.CR.IE := enable;
+   end set_interrupt;
+
+
+   procedure clear_errors
+   is
+      sr : t_RNG_SR;
+   begin
+      sr       := RNG.SR;
+      sr.CEIS  := false;
+      sr.SEIS  := false;
+      RNG.SR   := sr;
+   end clear_errors;
 
 
 end soc.rng;
@@ -0,0 +1,89 @@
+--
+-- Copyright 2018 The wookey project team <wookey@ssi.gouv.fr>
+--   - Ryad     Benadjila
+--   - Arnauld  Michelizza
+--   - Mathieu  Renard
+--   - Philippe Thierry
+--   - Philippe Trebuchet
+--
+-- Licensed under the Apache License, Version 2.0 (the "License");
+-- you may not use this file except in compliance with the License.
+-- You may obtain a copy of the License at
+--
+--     http://www.apache.org/licenses/LICENSE-2.0
+--
+--     Unless required by applicable law or agreed to in writing, software
+--     distributed under the License is distributed on an "AS IS" BASIS,
+--     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+--     See the License for the specific language governing permissions and
+--     limitations under the License.
+--
+--
+
+
+with soc.devmap;
+with soc.rcc;
+with soc.rcc.default;
+
+package body soc.tim
+   with spark_mode => off
+is
+
+   -- APB1 timers are clocked at twice the APB1 clock when the APB1
+   -- prescaler is not 1
+   TIMER_CLOCK : constant := 2 * soc.rcc.default.CLOCK_APB1;
+
+
+   procedure init
+     (frequency : in  unsigned_32)
+   is
+   begin
+      soc.rcc.enable_clock (soc.devmap.TIM5);
+
+      TIM5.CR1    := (CEN => false, UDIS => false, URS => true,
+                      OPM => false, DIR  => 0,     CMS => 0,
+                      ARPE => false, CKD => 0);
+      TIM5.DIER   := (UIE => false, CC1IE => false);
+      TIM5.PSC    := TIMER_CLOCK / frequency - 1;
+      TIM5.ARR    := unsigned_32'last;
+
+      -- Loading the prescaler
+      TIM5.EGR    := (UG => true);
+      TIM5.SR     := (UIF => false, CC1IF => false);
+
+      TIM5.CR1.CEN := true;
+   end init;
+
+
+   function get_counter return unsigned_32
+   is
+   begin
+      return TIM5.CNT;
+   end get_counter;
+
+
+   procedure set_compare
+     (value     : in  unsigned_32)
+   is
+   begin
+      TIM5.CCR1         := value;
+      clear_compare_flag;
+      TIM5.DIER.CC1IE   := true;
+   end set_compare;
+
+
+   procedure disable_compare
+   is
+   begin
+      TIM5.DIER.CC1IE   := false;
+      clear_compare_flag;
+   end disable_compare;
+
+
+   procedure clear_compare_flag
+   is
+   begin
+      TIM5.SR := (UIF => true, CC1IF => false);
+   end clear_compare_flag;
+
+end soc.tim;
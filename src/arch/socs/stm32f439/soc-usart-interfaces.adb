@@ -24,6 +24,21 @@ package body soc.usart.interfaces
    with spark_mode => off
 is
 
+   function get_usart
+     (usart_id : unsigned_8)
+      return t_USART_peripheral_access
+   is
+   begin
+      case usart_id is
+         when 1 => return USART1'access;
+         when 4 => return UART4'access;
+         when 6 => return USART6'access;
+         when others =>
+            raise program_error;
+      end case;
+   end get_usart;
+
+
    procedure configure
      (usart_id : in  unsigned_8;
       baudrate : in  unsigned_32;
@@ -81,4 +96,46 @@ is
       end case;
    end transmit;
 
+
+   function get_interrupt
+     (usart_id : unsigned_8)
+      return soc.interrupts.t_interrupt
+   is
+   begin
+      case usart_id is
+         when 1 => return soc.interrupts.INT_USART1;
+         when 4 => return soc.interrupts.INT_UART4;
+         when 6 => return soc.interrupts.INT_USART6;
+         when others =>
+            raise program_error;
+      end case;
+   end get_interrupt;
+
+
+   function is_tx_empty
+     (usart_id : unsigned_8)
+      return boolean
+   is
+   begin
+      return get_usart (usart_id).all.SR.TXE;
+   end is_tx_empty;
+
+
+   procedure put
+     (usart_id : in  unsigned_8;
+      data     : in  t_USART_DR)
+   is
+   begin
+      get_usart (usart_id).all.DR := data;
+   end put;
+
+
+   procedure set_tx_interrupt
+     (usart_id : in  unsigned_8;
+      enable   : in  boolean)
+   is
+   begin
+      get_usart (usart_id).all.CR1.TXEIE := enable;
+   end set_tx_interrupt;
+
 end soc.usart.interfaces;
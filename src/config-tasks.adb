@@ -3,6 +3,7 @@ with interfaces;        use interfaces;
 with types;             use types;
 with config.memlayout;
 with ewok.debug;
+with ewok.memops;
 
 package body config.tasks
   with spark_mode => off
@@ -25,16 +26,16 @@ is
                + to_unsigned_32 (CFGAPP.list(id).data_size)
                + to_unsigned_32 (CFGAPP.list(id).stack_size);
 
-            bss_region : byte_array (1 .. to_unsigned_32 (CFGAPP.list(id).bss_size))
-                           with address => to_address (bss_address);
+            bss_size    : constant unsigned_32 :=
+               to_unsigned_32 (CFGAPP.list(id).bss_size);
 
          begin
-            ewok.debug.log
+            pragma DEBUG (ewok.debug.log
               (ewok.debug.INFO, "zeroify bss: task " & id'image &
                ", at " & system_address'image (bss_address) &
-               ", " & unsigned_16'image (CFGAPP.list(id).bss_size) & " bytes");
+               ", " & unsigned_16'image (CFGAPP.list(id).bss_size) & " bytes"));
 
-            bss_region := (others => 0);
+            ewok.memops.fill (bss_address, 0, bss_size);
          end;
 
       end if;
@@ -52,24 +53,21 @@ is
                CFGMEM.apps_region.flash_memory_addr
                + CFGAPP.list(id).data_flash_offset;
 
-            data_in_flash  : byte_array (1 .. to_unsigned_32 (CFGAPP.list(id).data_size))
-                                with address => to_address (data_in_flash_address);
-
             data_in_ram_address : constant system_address :=
                CFGMEM.apps_region.ram_memory_addr
                + CFGAPP.list(id).data_offset
                + to_unsigned_32 (CFGAPP.list(id).stack_size);
 
-            data_in_ram    : byte_array (1 .. to_unsigned_32 (CFGAPP.list(id).data_size))
-                                with address => to_address (data_in_ram_address);
          begin
-            ewok.debug.log
+            pragma DEBUG (ewok.debug.log
               (ewok.debug.INFO, "task " & id'image & ": copy data from " &
                system_address'image (data_in_flash_address) & " to " &
                system_address'image (data_in_ram_address) & ", size " &
-               CFGAPP.list(id).data_size'image);
+               CFGAPP.list(id).data_size'image));
 
-            data_in_ram := data_in_flash;
+            ewok.memops.copy
+              (data_in_ram_address, data_in_flash_address,
+               to_unsigned_32 (CFGAPP.list(id).data_size));
          end;
       end if;
    end copy_data_to_ram;
@@ -23,6 +23,9 @@
 with ewok.tasks;        use ewok.tasks;
 with ewok.tasks_shared; use ewok.tasks_shared;
 with ewok.softirq;
+#if CONFIG_KERNEL_BENCH
+with ewok.bench;
+#end if;
 
 package body ewok.alarm
    with spark_mode => off
@@ -60,13 +63,22 @@ is
    is
       t           : constant m4.systick.t_tick := m4.systick.get_ticks;
       soft_params : ewok.softirq.t_soft_parameters;
+      ok          : boolean;
    begin
       if alarm_state(task_id).time > 0 and
          t > alarm_state(task_id).time
       then
          soft_params := (alarm_state(task_id).handler, unsigned_32 (t), 0, 0);
-         ewok.softirq.push_soft (task_id, soft_params);
-         unset_alarm (task_id);
+         ewok.softirq.push_soft_coalesced (task_id, soft_params, ok);
+
+         -- The softirq queue is full: the alarm stays set and is
+         -- delivered on a next tick
+         if ok then
+            unset_alarm (task_id);
+#if CONFIG_KERNEL_BENCH
+            ewok.bench.start_wakeup (task_id, ewok.bench.BENCH_ALARM_WAKEUP);
+#end if;
+         end if;
       end if;
    end check_alarm;
 
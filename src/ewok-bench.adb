@@ -0,0 +1,155 @@
+--
+-- Copyright 2018 The wookey project team <wookey@ssi.gouv.fr>
+--   - Ryad     Benadjila
+--   - Arnauld  Michelizza
+--   - Mathieu  Renard
+--   - Philippe Thierry
+--   - Philippe Trebuchet
+--
+-- Licensed under the Apache License, Version 2.0 (the "License");
+-- you may not use this file except in compliance with the License.
+-- You may obtain a copy of the License at
+--
+--     http://www.apache.org/licenses/LICENSE-2.0
+--
+--     Unless required by applicable law or agreed to in writing, software
+--     distributed under the License is distributed on an "AS IS" BASIS,
+--     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+--     See the License for the specific language governing permissions and
+--     limitations under the License.
+--
+--
+
+with ewok.tasks_shared;    use ewok.tasks_shared;
+with ewok.cycles;
+
+package body ewok.bench
+   with spark_mode => off
+is
+
+   BENCH_MAGIC : constant unsigned_32 := 16#4843_4E42#; -- "BNCH"
+
+   NO_STATS    : ewok.cycles.t_cycles_stats renames ewok.cycles.NO_STATS;
+
+   type t_svc_stats is
+      array (ewok.syscalls.t_svc) of ewok.cycles.t_cycles_stats;
+   type t_point_stats is
+      array (t_bench_point) of ewok.cycles.t_cycles_stats;
+
+   -- Layout decoded by tools/bench.py
+   type t_bench_buffer is record
+      magic       : unsigned_32;
+      svc_count   : unsigned_32;
+      point_count : unsigned_32;
+      reserved    : unsigned_32;
+      svcs        : t_svc_stats;
+      points      : t_point_stats;
+   end record;
+
+   bench_stats : t_bench_buffer :=
+     (magic       => BENCH_MAGIC,
+      svc_count   => ewok.syscalls.t_svc'pos (ewok.syscalls.t_svc'last) + 1,
+      point_count => t_bench_point'pos (t_bench_point'last) + 1,
+      reserved    => 0,
+      svcs        => (others => NO_STATS),
+      points      => (others => NO_STATS))
+      with export, external_name => "ewok_bench_stats";
+
+   -- Syscall being executed. SVCs rejected before their number is decoded
+   -- are not accounted.
+   current_svc : ewok.syscalls.t_svc := ewok.syscalls.SVC_EXIT;
+   svc_decoded : boolean := false;
+
+   -- Wake ups being measured, and their starting cycle
+   type t_wakeups is
+      array (config.applications.t_real_task_id, t_wakeup_point) of boolean;
+   type t_wakeup_stamps is
+      array (config.applications.t_real_task_id, t_wakeup_point)
+         of unsigned_32;
+
+   wakeup_pending : t_wakeups       := (others => (others => false));
+   wakeup_stamp   : t_wakeup_stamps := (others => (others => 0));
+
+
+   procedure set_svc
+     (svc      : in  ewok.syscalls.t_svc)
+   is
+   begin
+      current_svc := svc;
+      svc_decoded := true;
+   end set_svc;
+
+
+   procedure account
+     (intr     : in  soc.interrupts.t_interrupt;
+      start    : in  unsigned_32)
+   is
+   begin
+      case intr is
+         when soc.interrupts.INT_SVC      =>
+            if svc_decoded then
+               ewok.cycles.account (bench_stats.svcs(current_svc), start);
+               svc_decoded := false;
+            end if;
+         when soc.interrupts.INT_PENDSV   =>
+            ewok.cycles.account (bench_stats.points(BENCH_PENDSV), start);
+         when soc.interrupts.INT_SYSTICK  =>
+            ewok.cycles.account (bench_stats.points(BENCH_SYSTICK), start);
+         when others =>
+            null;
+      end case;
+   end account;
+
+
+   procedure account_user_irq
+     (start    : in  unsigned_32)
+   is
+   begin
+      ewok.cycles.account (bench_stats.points(BENCH_USER_IRQ), start);
+   end account_user_irq;
+
+
+   procedure start_wakeup
+     (task_id  : in  config.applications.t_real_task_id;
+      point    : in  t_wakeup_point)
+   is
+   begin
+      if not wakeup_pending(task_id, point) then
+         wakeup_stamp(task_id, point)   := ewok.cycles.get_cycles;
+         wakeup_pending(task_id, point) := true;
+      end if;
+   end start_wakeup;
+
+
+   procedure task_elected
+     (task_id  : in  ewok.tasks_shared.t_task_id;
+      mode     : in  ewok.tasks_shared.t_task_mode)
+   is
+      thread   : t_task_mode;
+   begin
+      if task_id not in config.applications.t_real_task_id then
+         return;
+      end if;
+
+      for point in t_wakeup_point loop
+         thread := (if point = BENCH_ALARM_WAKEUP then
+                       TASK_MODE_ISRTHREAD else TASK_MODE_MAINTHREAD);
+
+         if wakeup_pending(task_id, point) and mode = thread then
+            ewok.cycles.account
+              (bench_stats.points(point), wakeup_stamp(task_id, point));
+            wakeup_pending(task_id, point) := false;
+         end if;
+      end loop;
+   end task_elected;
+
+
+   procedure reset
+   is
+   begin
+      bench_stats.svcs     := (others => NO_STATS);
+      bench_stats.points   := (others => NO_STATS);
+      wakeup_pending       := (others => (others => false));
+   end reset;
+
+end ewok.bench;
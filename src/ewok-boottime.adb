@@ -0,0 +1,56 @@
+--
+-- Copyright 2018 The wookey project team <wookey@ssi.gouv.fr>
+--   - Ryad     Benadjila
+--   - Arnauld  Michelizza
+--   - Mathieu  Renard
+--   - Philippe Thierry
+--   - Philippe Trebuchet
+--
+-- Licensed under the Apache License, Version 2.0 (the "License");
+-- you may not use this file except in compliance with the License.
+-- You may obtain a copy of the License at
+--
+--     http://www.apache.org/licenses/LICENSE-2.0
+--
+--     Unless required by applicable law or agreed to in writing, software
+--     distributed under the License is distributed on an "AS IS" BASIS,
+--     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+--     See the License for the specific language governing permissions and
+--     limitations under the License.
+--
+--
+
+
+with soc.dwt;
+with ewok.debug;
+
+package body ewok.boottime
+   with spark_mode => off
+is
+
+   -- DWT counter at the end of each phase. The counter is started at
+   -- the beginning of main.
+   stamps : array (t_boot_phase) of unsigned_32 := (others => 0);
+
+
+   procedure mark
+     (phase : in  t_boot_phase)
+   is
+   begin
+      soc.dwt.get_cycles_32 (stamps(phase));
+   end mark;
+
+
+   procedure dump
+   is
+      previous : unsigned_32 := 0;
+   begin
+      for phase in t_boot_phase'range loop
+         debug.log (debug.INFO, "boot: " & t_boot_phase'image (phase)
+            & unsigned_32'image (stamps(phase) - previous)
+            & " cycles (at" & unsigned_32'image (stamps(phase)) & ")");
+         previous := stamps(phase);
+      end loop;
+   end dump;
+
+end ewok.boottime;
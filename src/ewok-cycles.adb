@@ -0,0 +1,63 @@
+--
+-- Copyright 2018 The wookey project team <wookey@ssi.gouv.fr>
+--   - Ryad     Benadjila
+--   - Arnauld  Michelizza
+--   - Mathieu  Renard
+--   - Philippe Thierry
+--   - Philippe Trebuchet
+--
+-- Licensed under the Apache License, Version 2.0 (the "License");
+-- you may not use this file except in compliance with the License.
+-- You may obtain a copy of the License at
+--
+--     http://www.apache.org/licenses/LICENSE-2.0
+--
+--     Unless required by applicable law or agreed to in writing, software
+--     distributed under the License is distributed on an "AS IS" BASIS,
+--     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+--     See the License for the specific language governing permissions and
+--     limitations under the License.
+--
+--
+
+with soc.dwt;
+
+package body ewok.cycles
+   with spark_mode => off
+is
+
+   function get_cycles return unsigned_32
+   is
+      cycles : unsigned_32;
+   begin
+      soc.dwt.get_cycles_32 (cycles);
+      return cycles;
+   end get_cycles;
+
+
+   function elapsed
+     (start    : unsigned_32)
+      return unsigned_32
+   is
+   begin
+      return get_cycles - start;
+   end elapsed;
+
+
+   procedure account
+     (stats    : in out t_cycles_stats;
+      start    : in     unsigned_32)
+   is
+      cycles   : constant unsigned_32 := elapsed (start);
+   begin
+      stats.count := stats.count + 1;
+      stats.total := stats.total + unsigned_64 (cycles);
+      if cycles < stats.min then
+         stats.min := cycles;
+      end if;
+      if cycles > stats.max then
+         stats.max := cycles;
+      end if;
+   end account;
+
+end ewok.cycles;
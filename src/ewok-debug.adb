@@ -33,9 +33,16 @@ with soc.usart.interfaces;
 with soc.rcc;
 with soc.devmap;
 
+#if CONFIG_KERNEL_LOG_RING
+with ewok.interrupts;
+with soc.nvic;
+with m4.cpu;
+#end if;
+
 #if CONFIG_KERNEL_PANIC_WIPE
 with soc;
 with soc.layout; use soc.layout;
+with ewok.memops;
 #end if;
 
 #if not CONFIG_KERNEL_PANIC_FREEZE
@@ -109,6 +116,70 @@ is
       exti_handler   => 16#0000_0000#);
 
 
+#if CONFIG_KERNEL_LOG_RING
+   --
+   -- Log ring. The logged characters are enqueued, then transmitted one by
+   -- one by the kernel USART TXE interrupt handler
+   --
+
+   LOG_RING_SIZE  : constant := $CONFIG_KERNEL_LOG_RING_SIZE;
+
+   subtype t_log_index is natural range 0 .. LOG_RING_SIZE - 1;
+
+   log_ring       : array (t_log_index) of character;
+   log_head       : t_log_index := 0; -- Next character to enqueue
+   log_tail       : t_log_index := 0; -- Next character to transmit
+   log_count      : natural range 0 .. LOG_RING_SIZE := 0;
+
+   -- Characters dropped because the ring was full
+   log_dropped    : unsigned_32 := 0;
+
+
+   procedure tx_handler
+     (frame_a : in ewok.t_stack_frame_access)
+   is
+      pragma unreferenced (frame_a);
+      primask  : constant unsigned_32 := m4.cpu.get_primask_register;
+   begin
+      m4.cpu.disable_irq;
+
+      if log_count > 0 and then
+         soc.usart.interfaces.is_tx_empty (kernel_usart_id)
+      then
+         soc.usart.interfaces.put
+           (kernel_usart_id, character'pos (log_ring(log_tail)));
+         log_tail    := (log_tail + 1) mod LOG_RING_SIZE;
+         log_count   := log_count - 1;
+      end if;
+
+      if log_count = 0 then
+         soc.usart.interfaces.set_tx_interrupt (kernel_usart_id, false);
+      end if;
+
+      m4.cpu.set_primask_register (primask);
+   end tx_handler;
+
+
+   procedure flush
+   is
+      primask  : constant unsigned_32 := m4.cpu.get_primask_register;
+   begin
+      m4.cpu.disable_irq;
+
+      while log_count > 0 loop
+         soc.usart.interfaces.transmit
+           (kernel_usart_id, character'pos (log_ring(log_tail)));
+         log_tail    := (log_tail + 1) mod LOG_RING_SIZE;
+         log_count   := log_count - 1;
+      end loop;
+
+      soc.usart.interfaces.set_tx_interrupt (kernel_usart_id, false);
+
+      m4.cpu.set_primask_register (primask);
+   end flush;
+#end if;
+
+
    procedure init
      (usart : in unsigned_8)
    is
@@ -152,6 +223,21 @@ is
          raise program_error;
       end if;
 
+#if CONFIG_KERNEL_LOG_RING
+      ewok.interrupts.set_interrupt_handler
+        (soc.usart.interfaces.get_interrupt (kernel_usart_id),
+         tx_handler'access,
+         ID_KERNEL,
+         ID_DEV_UNUSED,
+         ok);
+      if not ok then
+         raise program_error;
+      end if;
+
+      soc.nvic.enable_irq (soc.nvic.to_irq_number
+        (soc.usart.interfaces.get_interrupt (kernel_usart_id)));
+#end if;
+
       log (INFO,
          "EwoK: USART" & unsigned_8'image (kernel_usart_id) & " initialized");
       newline;
@@ -161,9 +247,37 @@ is
 
    procedure putc (c : character)
    is
+#if CONFIG_KERNEL_LOG_RING
+      primask  : constant unsigned_32 := m4.cpu.get_primask_register;
+#end if;
    begin
 #if CONFIG_KERNEL_SERIAL
+#if CONFIG_KERNEL_LOG_RING
+      -- In thread mode with masked interrupts (kernel initialization),
+      -- the ring is not drained: characters are transmitted synchronously.
+      -- Note - kernel handlers are executed with masked interrupts. The
+      --        ring is drained at their exit.
+      if m4.cpu.get_ipsr_register.ISR_NUMBER = 0 and primask /= 0 then
+         flush;
+         soc.usart.interfaces.transmit (kernel_usart_id, character'pos (c));
+         return;
+      end if;
+
+      m4.cpu.disable_irq;
+
+      if log_count < LOG_RING_SIZE then
+         log_ring(log_head)   := c;
+         log_head    := (log_head + 1) mod LOG_RING_SIZE;
+         log_count   := log_count + 1;
+         soc.usart.interfaces.set_tx_interrupt (kernel_usart_id, true);
+      else
+         log_dropped := log_dropped + 1;
+      end if;
+
+      m4.cpu.set_primask_register (primask);
+#else
       soc.usart.interfaces.transmit (kernel_usart_id, character'pos (c));
+#end if;
 #else
       null;
 #end if;
@@ -173,6 +287,21 @@ is
    procedure log (s : string; nl : boolean := true)
    is
    begin
+#if CONFIG_KERNEL_LOG_RING
+      -- Reporting the characters lost since the last log
+      if log_dropped > 0 then
+         declare
+            dropped : constant unsigned_32 := log_dropped;
+            msg     : constant string :=
+               "[log:" & unsigned_32'image (dropped) & " chars dropped]";
+         begin
+            log_dropped := 0;
+            for i in msg'range loop
+               putc (msg(i));
+            end loop;
+         end;
+      end if;
+#end if;
       for i in s'range loop
          putc (s(i));
       end loop;
@@ -203,6 +332,11 @@ is
    is
    begin
       log (BG_COLOR_RED & s & BG_COLOR_BLACK, false);
+#if CONFIG_KERNEL_LOG_RING
+      -- Alerts are emitted from faults handlers and from the last chance
+      -- handler. The ring might not be drained anymore
+      flush;
+#end if;
    end alert;
 
 
@@ -217,6 +351,9 @@ is
    is
    begin
       log (BG_COLOR_RED & "panic: " & s & BG_COLOR_BLACK);
+#if CONFIG_KERNEL_LOG_RING
+      flush;
+#end if;
 
 #if CONFIG_KERNEL_PANIC_FREEZE
       loop null; end loop;
@@ -227,17 +364,12 @@ is
 #end if;
 
 #if CONFIG_KERNEL_PANIC_WIPE
-      declare
-         sram : array (0 .. soc.layout.USER_RAM_SIZE) of types.byte
-            with address => to_address(USER_RAM_BASE);
-      begin
-         -- Wiping the user applications in RAM before reseting. Kernel data
-         -- and bss are not cleared because the are in use and there should
-         -- be no sensible content in kernel data (secrets are hold by user tasks).
-         -- TODO: Clearing IPC content
-         sram := (others => 0);
-         m4.scb.reset;
-      end;
+      -- Wiping the user applications in RAM before reseting. Kernel data
+      -- and bss are not cleared because the are in use and there should
+      -- be no sensible content in kernel data (secrets are hold by user tasks).
+      -- TODO: Clearing IPC content
+      ewok.memops.fill (USER_RAM_BASE, 0, soc.layout.USER_RAM_SIZE);
+      m4.scb.reset;
 #end if;
    end panic;
 
@@ -110,24 +110,9 @@ is
      (interrupt : soc.interrupts.t_interrupt)
       return ewok.exported.interrupts.t_interrupt_config_access
    is
-      dev_id : t_device_id;
    begin
-
-      -- Retrieving the dev_id from the interrupt
-      dev_id := ewok.interrupts.get_device_from_interrupt (interrupt);
-      if dev_id = ID_DEV_UNUSED then
-         return NULL;
-      end if;
-
-      -- Looking at each interrupts configured for this device
-      -- to retrieve the proper interrupt configuration informations
-      for i in 1 .. registered_device(dev_id).udev.interrupt_num loop
-         if registered_device(dev_id).udev.interrupts(i).interrupt = interrupt
-         then
-            return registered_device(dev_id).udev.interrupts(i)'access;
-         end if;
-      end loop;
-      return NULL;
+      return ewok.exported.interrupts.t_interrupt_config_access
+        (ewok.interrupts.interrupt_table(interrupt).config);
    end get_interrupt_config_from_interrupt;
 
    ------------------------
@@ -157,6 +142,8 @@ is
       registered_device(dev_id).status    := DEV_STATE_UNUSED;
       registered_device(dev_id).task_id   := ID_UNUSED;
       registered_device(dev_id).periph_id := NO_PERIPH;
+      registered_device(dev_id).posthooks :=
+        (others => ewok.posthook.ID_POSTHOOK_UNUSED);
       -- FIXME initialize registered_device(dev_id).udev with 0 values
    end release_registered_device_entry;
 
@@ -188,6 +175,14 @@ is
             success := false;
             return;
          end if;
+#if CONFIG_KERNEL_ALARM_HRTIMER
+         -- TIM5 is used by the kernel high resolution alarms
+         if periph_id = soc.devmap.TIM5 then
+            pragma DEBUG (debug.log (debug.ERROR, "Device used by the kernel: " & name));
+            success := false;
+            return;
+         end if;
+#end if;
       end if;
 
       -- Is it already used ?
@@ -246,6 +241,18 @@ is
          end if;
       end loop;
 
+#if CONFIG_KERNEL_RNG_POOL
+      -- The HASH interrupt is shared with the RNG, used by the kernel
+      -- entropy pool
+      for i in 1 .. udev.interrupt_num loop
+         if udev.interrupts(i).interrupt = INT_HASH_RNG then
+            pragma DEBUG (debug.log (debug.ERROR, "Interrupt used by the kernel: " & name));
+            success := false;
+            return;
+         end if;
+      end loop;
+#end if;
+
       -- Is it possible to register interrupt handlers ?
       for i in 1 .. udev.interrupt_num loop
          if ewok.interrupts.is_interrupt_already_used
@@ -273,6 +280,24 @@ is
       registered_device(dev_id).periph_id := periph_id;
       registered_device(dev_id).status    := DEV_STATE_REGISTERED;
 
+      -- Compiling posthooks
+      for i in 1 .. udev.interrupt_num loop
+         ewok.posthook.compile
+           (registered_device(dev_id).udev.interrupts(i),
+            get_device_addr (dev_id),
+            registered_device(dev_id).posthooks(i),
+            success);
+         if not success then
+            pragma DEBUG (debug.log (debug.ERROR,
+               "register_device(): no free posthook's slot!"));
+            for j in 1 .. i - 1 loop
+               ewok.posthook.release (registered_device(dev_id).posthooks(j));
+            end loop;
+            release_registered_device_entry (dev_id);
+            return;
+         end if;
+      end loop;
+
       -- Registering GPIOs
       for i in 1 .. udev.gpio_num loop
          ewok.gpio.register
@@ -310,6 +335,11 @@ is
          if not success then
             raise program_error;
          end if;
+
+         ewok.interrupts.set_interrupt_config
+           (udev.interrupts(i).interrupt,
+            registered_device(dev_id).udev.interrupts(i)'access,
+            ewok.posthook.get_program (registered_device(dev_id).posthooks(i)));
       end loop;
 
       success := true;
@@ -346,6 +376,7 @@ is
            (registered_device(dev_id).udev.interrupts(i).interrupt,
             task_id,
             dev_id);
+         ewok.posthook.release (registered_device(dev_id).posthooks(i));
       end loop;
 
       -- Releasing the device
@@ -431,6 +462,13 @@ is
          return false;
       end if;
 
+#if CONFIG_KERNEL_ISR_COALESCING
+      if not config.coalescing'valid then
+         pragma DEBUG (debug.log (debug.ERROR, "Invalid coalescing mode"));
+         return false;
+      end if;
+#end if;
+
       --
       -- Verify posthooks
       --
@@ -0,0 +1,68 @@
+--
+-- Copyright 2018 The wookey project team <wookey@ssi.gouv.fr>
+--   - Ryad     Benadjila
+--   - Arnauld  Michelizza
+--   - Mathieu  Renard
+--   - Philippe Thierry
+--   - Philippe Trebuchet
+--
+-- Licensed under the Apache License, Version 2.0 (the "License");
+-- you may not use this file except in compliance with the License.
+-- You may obtain a copy of the License at
+--
+--     http://www.apache.org/licenses/LICENSE-2.0
+--
+--     Unless required by applicable law or agreed to in writing, software
+--     distributed under the License is distributed on an "AS IS" BASIS,
+--     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+--     See the License for the specific language governing permissions and
+--     limitations under the License.
+--
+--
+
+package body ewok.dma.stats
+   with spark_mode => off
+is
+
+   procedure account
+     (op       : in  t_operation;
+      start    : in  unsigned_32)
+   is
+   begin
+      ewok.cycles.account (operations(op), start);
+   end account;
+
+
+   procedure account_status
+     (interrupt   : in  soc.interrupts.t_interrupt;
+      status      : in  soc.dma.t_dma_stream_int_status)
+   is
+      dma_id   : soc.dma.t_dma_periph_index;
+      stream   : soc.dma.t_stream_index;
+      ok       : boolean;
+   begin
+
+      soc.dma.get_dma_stream_from_interrupt (interrupt, dma_id, stream, ok);
+      if not ok then
+         return;
+      end if;
+
+      if status.TRANSFER_ERROR or status.DIRECT_MODE_ERROR then
+         streams(dma_id, stream).errors :=
+            streams(dma_id, stream).errors + 1;
+      elsif status.TRANSFER_COMPLETE then
+         streams(dma_id, stream).transfers :=
+            streams(dma_id, stream).transfers + 1;
+      end if;
+
+   end account_status;
+
+
+   procedure reset
+   is
+   begin
+      operations  := (others => ewok.cycles.NO_STATS);
+      streams     := (others => (others => (transfers => 0, errors => 0)));
+   end reset;
+
+end ewok.dma.stats;
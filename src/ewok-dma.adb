@@ -34,6 +34,7 @@ with ewok.perm;
 with soc.dma;              use soc.dma;
 with soc.dma.interfaces;   use soc.dma.interfaces;
 with soc.nvic;
+with types.c;
 
 package body ewok.dma
    with spark_mode => off
@@ -123,14 +124,23 @@ is
    end task_owns_dma_stream;
 
 
+   -- Start a configured stream
+   procedure start_stream
+     (index : in ewok.dma_shared.t_registered_dma_index)
+   is
+   begin
+      soc.dma.interfaces.enable_stream
+        (registered_dma(index).config.dma_id,
+         registered_dma(index).config.stream);
+   end start_stream;
+
+
    procedure enable_dma_stream
      (index : in ewok.dma_shared.t_registered_dma_index)
    is
    begin
       if registered_dma(index).status = DMA_CONFIGURED then
-         soc.dma.interfaces.enable_stream
-           (registered_dma(index).config.dma_id,
-            registered_dma(index).config.stream);
+         start_stream (index);
       end if;
    end enable_dma_stream;
 
@@ -170,6 +180,7 @@ is
       if config.in_addr  = 0 or
          config.out_addr = 0 or
          config.bytes    = 0 or
+         (config.mode = DOUBLE_BUFFER_MODE and config.mem1_addr = 0) or
 #if CONFIG_KERNEL_DMA_DIRECTCOPY
          (config.transfer_dir  = MEMORY_TO_MEMORY and config.in_handler = 0)
          or
@@ -196,6 +207,47 @@ is
    is
    begin
 
+      -- Circular mode is only supported between a device and the memory.
+      -- Double buffer mode also requires the DMA to be the flow controller.
+      -- On reconfiguration, user_config must have been merged with the
+      -- current configuration of the stream (see merge_user_config())
+      case user_config.mode is
+         when CIRCULAR_MODE      =>
+            if user_config.transfer_dir = MEMORY_TO_MEMORY then
+               return false;
+            end if;
+         when DOUBLE_BUFFER_MODE =>
+            if user_config.transfer_dir    = MEMORY_TO_MEMORY or
+               user_config.flow_controller = PERIPH_FLOW_CONTROLLER
+            then
+               return false;
+            end if;
+         when DIRECT_MODE | FIFO_MODE =>
+            null;
+      end case;
+
+      -- The second buffer (double buffer mode) has the size of the first
+      -- one. It is checked again whenever the mode, the size or the memory
+      -- buffer of the stream change
+      if user_config.mode = DOUBLE_BUFFER_MODE and
+         user_config.mem1_addr /= 0 and
+         (to_configure.mode or to_configure.buffer_size or
+          to_configure.buffer_in or to_configure.buffer_out)
+      then
+         if not ewok.sanitize.is_range_in_any_region
+                 (user_config.mem1_addr, unsigned_32 (user_config.size),
+                  caller_id, mode)
+            and
+            not ewok.sanitize.is_range_in_dma_shm
+                 (user_config.mem1_addr, unsigned_32 (user_config.size),
+                  (if user_config.transfer_dir = PERIPHERAL_TO_MEMORY then
+                      SHM_ACCESS_WRITE else SHM_ACCESS_READ),
+                  caller_id)
+         then
+            return false;
+         end if;
+      end if;
+
       case user_config.transfer_dir is
          when PERIPHERAL_TO_MEMORY  =>
 
@@ -345,6 +397,66 @@ is
    end sanitize_dma_shm;
 
 
+   procedure merge_user_config
+     (user_config    : in out ewok.exported.dma.t_dma_user_config;
+      index          : in     ewok.dma_shared.t_registered_dma_index;
+      to_configure   : in     ewok.exported.dma.t_config_mask)
+   is
+      config      : soc.dma.interfaces.t_dma_config
+                        renames registered_dma(index).config;
+   begin
+
+      -- Fields that can't be reconfigured
+      user_config.flow_controller   := config.flow_controller;
+      user_config.data_size         := config.data_size;
+      user_config.memory_inc        := types.c.bool (config.memory_inc);
+      user_config.periph_inc        := types.c.bool (config.periph_inc);
+      user_config.mem_burst_size    := config.mem_burst_size;
+      user_config.periph_burst_size := config.periph_burst_size;
+
+      if not to_configure.direction then
+         user_config.transfer_dir   := config.transfer_dir;
+      end if;
+
+      if not to_configure.mode then
+         user_config.mode           := config.mode;
+         user_config.half_transfer  := types.c.bool (config.half_transfer);
+      end if;
+
+      if not to_configure.buffer_size then
+         user_config.size           := config.bytes;
+      end if;
+
+      if not to_configure.buffer_in then
+         user_config.in_addr        := config.in_addr;
+      end if;
+
+      if not to_configure.buffer_out then
+         user_config.out_addr       := config.out_addr;
+      end if;
+
+      -- The second buffer is set (and checked) with the memory buffer
+      if not ((to_configure.buffer_out and
+               user_config.transfer_dir = PERIPHERAL_TO_MEMORY) or
+              (to_configure.buffer_in and
+               user_config.transfer_dir = MEMORY_TO_PERIPHERAL))
+      then
+         user_config.mem1_addr      := config.mem1_addr;
+      end if;
+
+      if not to_configure.priority then
+         user_config.in_priority    := config.in_priority;
+         user_config.out_priority   := config.out_priority;
+      end if;
+
+      if not to_configure.handlers then
+         user_config.in_handler     := config.in_handler;
+         user_config.out_handler    := config.out_handler;
+      end if;
+
+   end merge_user_config;
+
+
    procedure reconfigure_stream
      (user_config    : in out ewok.exported.dma.t_dma_user_config;
       index          : in     ewok.dma_shared.t_registered_dma_index;
@@ -370,8 +482,19 @@ is
          registered_dma(index).config.out_addr := user_config.out_addr;
       end if;
 
+      -- The second buffer is set (and checked) with the memory buffer
+      if (to_configure.buffer_out and
+          user_config.transfer_dir = PERIPHERAL_TO_MEMORY) or
+         (to_configure.buffer_in and
+          user_config.transfer_dir = MEMORY_TO_PERIPHERAL)
+      then
+         registered_dma(index).config.mem1_addr := user_config.mem1_addr;
+      end if;
+
       if to_configure.mode then
          registered_dma(index).config.mode := user_config.mode;
+         registered_dma(index).config.half_transfer :=
+            boolean (user_config.half_transfer);
       end if;
 
       if to_configure.priority then
@@ -467,13 +590,29 @@ is
         (registered_dma(index).config.dma_id,
          registered_dma(index).config.stream,
          registered_dma(index).config,
-         soc.dma.interfaces.t_config_mask (to_configure));
+         soc.dma.interfaces.t_config_mask (to_configure),
+         ok);
+
+      if not ok then
+         pragma DEBUG (debug.log (debug.ERROR, "reconfigure_stream(): mode not supported"));
+         registered_dma(index).status := DMA_USED;
+         success := false;
+         return;
+      end if;
+
+#if CONFIG_KERNEL_DMA_CHAINS
+      -- The chain is overridden by the new buffers or transfer properties
+      if to_configure.buffer_in   or to_configure.buffer_out or
+         to_configure.buffer_size or to_configure.mode       or
+         to_configure.direction
+      then
+         clear_chain (index);
+      end if;
+#end if;
 
       if is_config_complete (registered_dma(index).config) then
          registered_dma(index).status := DMA_CONFIGURED;
-         soc.dma.interfaces.enable_stream
-           (registered_dma(index).config.dma_id,
-            registered_dma(index).config.stream);
+         start_stream (index);
       else
          registered_dma(index).status := DMA_USED;
       end if;
@@ -520,7 +659,9 @@ is
          memory_inc        => boolean (user_config.memory_inc),
          periph_inc        => boolean (user_config.periph_inc),
          mem_burst_size    => user_config.mem_burst_size,
-         periph_burst_size => user_config.periph_burst_size);
+         periph_burst_size => user_config.periph_burst_size,
+         mem1_addr         => user_config.mem1_addr,
+         half_transfer     => boolean (user_config.half_transfer));
 
       registered_dma(index).task_id    := caller_id;
       registered_dma(index).periph_id  :=
@@ -596,7 +737,16 @@ is
       soc.dma.interfaces.configure_stream
         (registered_dma(index).config.dma_id,
          registered_dma(index).config.stream,
-         registered_dma(index).config);
+         registered_dma(index).config,
+         ok);
+
+      if not ok then
+         pragma DEBUG (debug.log ("dma.init(): mode not supported"));
+         registered_dma(index).status := DMA_USED;
+         release_stream (caller_id, index, ok);
+         success := false;
+         return;
+      end if;
 
       success := true;
 
@@ -642,6 +792,7 @@ is
      (caller_id : in  ewok.tasks_shared.t_task_id;
       interrupt : in  soc.interrupts.t_interrupt;
       status    : out soc.dma.t_dma_stream_int_status;
+      target    : out soc.dma.t_current_target;
       success   : out boolean)
    is
       soc_dma_id     : soc.dma.t_dma_periph_index;
@@ -668,6 +819,9 @@ is
       status := soc.dma.interfaces.get_interrupt_status
         (soc_dma_id, soc_stream_id);
 
+      target := soc.dma.interfaces.get_current_target
+        (soc_dma_id, soc_stream_id);
+
       soc.dma.interfaces.clear_all_interrupts (soc_dma_id, soc_stream_id);
 
       success := true;
@@ -711,9 +865,365 @@ is
       registered_dma(index).periph_id  := soc.devmap.NO_PERIPH;
       registered_dma(index).task_id    := ID_UNUSED;
 
+#if CONFIG_KERNEL_DMA_CHAINS
+      clear_chain (index);
+#end if;
+
       success := true;
 
    end release_stream;
 
 
+   -- Set the memory side buffer and the size of the stream
+   procedure set_memory_buffer
+     (index          : in     ewok.dma_shared.t_registered_dma_index;
+      addr           : in     system_address;
+      size           : in     unsigned_16;
+      success        : out    boolean)
+   is
+      config      : soc.dma.interfaces.t_dma_config
+                        renames registered_dma(index).config;
+      mask        : soc.dma.interfaces.t_config_mask := (others => false);
+   begin
+
+      case config.transfer_dir is
+         when PERIPHERAL_TO_MEMORY  =>
+            config.out_addr   := addr;
+            mask.buffer_out   := true;
+         when MEMORY_TO_PERIPHERAL  =>
+            config.in_addr    := addr;
+            mask.buffer_in    := true;
+         when MEMORY_TO_MEMORY      =>
+            success := false;
+            return;
+      end case;
+
+      config.bytes      := size;
+      mask.buffer_size  := true;
+
+      soc.dma.interfaces.reconfigure_stream
+        (config.dma_id, config.stream, config, mask, success);
+
+   end set_memory_buffer;
+
+
+   procedure register_buffer
+     (caller_id      : in     ewok.tasks_shared.t_task_id;
+      base           : in     system_address;
+      size           : in     unsigned_32;
+      access_type    : in     ewok.exported.dma.t_dma_shm_access;
+      handle         : out    unsigned_32;
+      success        : out    boolean)
+   is
+      user_task   : ewok.tasks.t_task renames ewok.tasks.tasks_list(caller_id);
+      owner_id    : ewok.tasks_shared.t_task_id := ID_UNUSED;
+   begin
+
+      handle := 0;
+
+      if size = 0 or size > unsigned_32 (unsigned_16'last) then
+         success := false;
+         return;
+      end if;
+
+      -- The buffer is checked against the main thread regions. Thus, it
+      -- can't be in the ISR stack, which is shared between tasks.
+      if ewok.sanitize.is_range_in_any_region
+           (base, size, caller_id, TASK_MODE_MAINTHREAD)
+      then
+         owner_id := caller_id;
+      else
+         for i in 1 .. user_task.num_dma_shms loop
+            if user_task.dma_shm(i).granted_id  = caller_id   and
+               user_task.dma_shm(i).access_type = access_type and
+               base >= user_task.dma_shm(i).base               and
+               base + size >= base                             and
+               base + size <= (user_task.dma_shm(i).base +
+                               user_task.dma_shm(i).size)
+            then
+               owner_id := user_task.dma_shm(i).accessed_id;
+               exit;
+            end if;
+         end loop;
+      end if;
+
+      if owner_id = ID_UNUSED then
+         pragma DEBUG (debug.log (debug.ERROR, "register_buffer(): buffer not in task's memory space"));
+         success := false;
+         return;
+      end if;
+
+      for i in user_task.dma_buffers'range loop
+         if user_task.dma_buffers(i).owner_id = ID_UNUSED then
+            user_task.dma_buffers(i) :=
+              (base        => base,
+               size        => size,
+               access_type => access_type,
+               owner_id    => owner_id);
+            handle  := i;
+            success := true;
+            return;
+         end if;
+      end loop;
+
+      success := false;
+
+   end register_buffer;
+
+
+   procedure release_buffers
+     (owner_id       : in     ewok.tasks_shared.t_task_id)
+   is
+   begin
+      for id in ewok.tasks.tasks_list'range loop
+         for i in ewok.tasks.tasks_list(id).dma_buffers'range loop
+            if ewok.tasks.tasks_list(id).dma_buffers(i).owner_id = owner_id
+            then
+               ewok.tasks.tasks_list(id).dma_buffers(i) :=
+                 (base        => 0,
+                  size        => 0,
+                  access_type => SHM_ACCESS_READ,
+                  owner_id    => ID_UNUSED);
+            end if;
+         end loop;
+      end loop;
+   end release_buffers;
+
+
+   procedure reconfigure_buffer
+     (index          : in     ewok.dma_shared.t_registered_dma_index;
+      addr           : in     system_address;
+      size           : in     unsigned_16;
+      success        : out    boolean)
+   is
+      config      : soc.dma.interfaces.t_dma_config
+                        renames registered_dma(index).config;
+   begin
+
+      if config.transfer_dir = MEMORY_TO_MEMORY then
+         success := false;
+         return;
+      end if;
+
+      set_memory_buffer (index, addr, size, success);
+      if not success then
+         return;
+      end if;
+
+#if CONFIG_KERNEL_DMA_CHAINS
+      clear_chain (index);
+#end if;
+
+      if is_config_complete (config) then
+         registered_dma(index).status := DMA_CONFIGURED;
+         start_stream (index);
+      else
+         registered_dma(index).status := DMA_USED;
+      end if;
+
+      success := true;
+
+   end reconfigure_buffer;
+
+
+#if CONFIG_KERNEL_DMA_CHAINS
+
+   function sanitize_dma_chain
+     (index          : ewok.dma_shared.t_registered_dma_index;
+      segments       : ewok.exported.dma.t_dma_segment_list;
+      caller_id      : ewok.tasks_shared.t_task_id;
+      mode           : ewok.tasks_shared.t_task_mode)
+      return boolean
+   is
+      config      : soc.dma.interfaces.t_dma_config
+                        renames registered_dma(index).config;
+      access_type : t_dma_shm_access;
+   begin
+
+      if registered_dma(index).status   = DMA_UNUSED or
+         registered_dma(index).task_id /= caller_id
+      then
+         return false;
+      end if;
+
+      -- Each segment is a distinct transfer, ended by the DMA controller
+      if (config.mode /= DIRECT_MODE and config.mode /= FIFO_MODE) or
+         config.flow_controller = PERIPH_FLOW_CONTROLLER
+      then
+         pragma DEBUG (debug.log (debug.ERROR, "sanitize_dma_chain(): unsupported DMA mode"));
+         return false;
+      end if;
+
+      -- Segments are the memory side buffers
+      case config.transfer_dir is
+         when PERIPHERAL_TO_MEMORY  => access_type := SHM_ACCESS_WRITE;
+         when MEMORY_TO_PERIPHERAL  => access_type := SHM_ACCESS_READ;
+         when MEMORY_TO_MEMORY      => return false;
+      end case;
+
+      for i in segments'range loop
+
+         if segments(i).size = 0 then
+            return false;
+         end if;
+
+         -- In direct mode, the size is counted in data items
+         if config.mode = DIRECT_MODE and
+            ((config.data_size = TRANSFER_HALF_WORD and
+              segments(i).size mod 2 /= 0) or
+             (config.data_size = TRANSFER_WORD and
+              segments(i).size mod 4 /= 0))
+         then
+            return false;
+         end if;
+
+         if not ewok.sanitize.is_range_in_any_region
+                 (segments(i).addr, unsigned_32 (segments(i).size),
+                  caller_id, mode)
+            and
+            not ewok.sanitize.is_range_in_dma_shm
+                 (segments(i).addr, unsigned_32 (segments(i).size),
+                  access_type, caller_id)
+         then
+            pragma DEBUG (debug.log (debug.ERROR, "sanitize_dma_chain(): segment not in task's memory space"));
+            return false;
+         end if;
+
+      end loop;
+
+      return true;
+
+   end sanitize_dma_chain;
+
+
+   procedure set_chain
+     (index          : in     ewok.dma_shared.t_registered_dma_index;
+      segments       : in     ewok.exported.dma.t_dma_segment_list;
+      success        : out    boolean)
+   is
+      chain : t_dma_chain renames dma_chains(index);
+   begin
+
+      if segments'length = 0 or
+         segments'length > ewok.exported.dma.MAX_DMA_SEGMENTS
+      then
+         success := false;
+         return;
+      end if;
+
+      chain.count := unsigned_8 (segments'length);
+      chain.segments(1 .. chain.count) := segments;
+
+      chain.current := chain.segments'first;
+      set_memory_buffer
+        (index, chain.segments(chain.current).addr,
+         chain.segments(chain.current).size,
+         success);
+
+      if not success then
+         clear_chain (index);
+         return;
+      end if;
+
+      if is_config_complete (registered_dma(index).config) then
+         registered_dma(index).status := DMA_CONFIGURED;
+         start_stream (index);
+      else
+         registered_dma(index).status := DMA_USED;
+      end if;
+
+      success := true;
+
+   end set_chain;
+
+
+   procedure clear_chain
+     (index          : in     ewok.dma_shared.t_registered_dma_index)
+   is
+   begin
+      dma_chains(index).count    := 0;
+      dma_chains(index).current  := 0;
+   end clear_chain;
+
+
+   procedure continue_chain
+     (caller_id      : in     ewok.tasks_shared.t_task_id;
+      interrupt      : in     soc.interrupts.t_interrupt;
+      status         : in     soc.dma.t_dma_stream_int_status;
+      pending        : out    boolean)
+   is
+      soc_dma_id     : soc.dma.t_dma_periph_index;
+      soc_stream_id  : soc.dma.t_stream_index;
+      ok             : boolean;
+   begin
+
+      pending := false;
+
+      soc.dma.get_dma_stream_from_interrupt
+        (interrupt, soc_dma_id, soc_stream_id, ok);
+
+      if not ok then
+         return;
+      end if;
+
+      for index in registered_dma'range loop
+         if registered_dma(index).task_id       = caller_id     and
+            registered_dma(index).config.dma_id = soc_dma_id    and
+            registered_dma(index).config.stream = soc_stream_id
+         then
+            declare
+               chain : t_dma_chain renames dma_chains(index);
+            begin
+
+               if chain.current = 0 or
+                  registered_dma(index).status /= DMA_CONFIGURED
+               then
+                  return;
+               end if;
+
+               -- Other events (FIFO error...) are reported to the task
+               -- without altering the chain
+               if not status.TRANSFER_COMPLETE and
+                  not status.TRANSFER_ERROR    and
+                  not status.DIRECT_MODE_ERROR
+               then
+                  return;
+               end if;
+
+               if status.TRANSFER_COMPLETE    and
+                  not status.TRANSFER_ERROR   and
+                  not status.DIRECT_MODE_ERROR and
+                  chain.current < chain.count
+               then
+                  chain.current := chain.current + 1;
+                  set_memory_buffer
+                    (index, chain.segments(chain.current).addr,
+                     chain.segments(chain.current).size,
+                     ok);
+                  if ok then
+                     start_stream (index);
+                     pending := true;
+                  end if;
+               else
+                  -- End of chain or error: rewinding the chain. The stream
+                  -- is left disabled.
+                  soc.dma.interfaces.disable_stream
+                    (soc_dma_id, soc_stream_id);
+                  chain.current := chain.segments'first;
+                  set_memory_buffer
+                    (index, chain.segments(chain.current).addr,
+                     chain.segments(chain.current).size,
+                     ok);
+               end if;
+
+               return;
+            end;
+         end if;
+      end loop;
+
+   end continue_chain;
+
+#end if;
+
+
 end ewok.dma;
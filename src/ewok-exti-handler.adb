@@ -20,19 +20,20 @@
 --
 --
 
-with soc.gpio;             use soc.gpio;
 with soc.exti;             use soc.exti;
-with soc.syscfg;
 with soc.nvic;
+with soc.dwt;
 with soc.interrupts;
-with ewok.interrupts;
-with ewok.exported.gpios;   use type ewok.exported.gpios.t_gpio_config_access;
-                            use type ewok.exported.gpios.t_interface_gpio_exti_lock;
-with ewok.gpio;
-with ewok.tasks_shared;
+with m4.cpu.instructions;
+with ewok.interrupts;       use type ewok.interrupts.t_interrupt_handler_access;
+with ewok.exported.gpios;   use type ewok.exported.gpios.t_interface_gpio_exti_lock;
+with ewok.tasks_shared;     use type ewok.tasks_shared.t_task_id;
 with ewok.devices_shared;
 with ewok.isr;
 with ewok.debug;
+#if CONFIG_KERNEL_TRACE_EXTI
+with ewok.trace;
+#end if;
 
 package body ewok.exti.handler
    with spark_mode => off
@@ -109,52 +110,81 @@ is
    end init;
 
 
-   procedure handle_line
-     (line        : in  soc.exti.t_exti_line_index;
-      interrupt   : in  soc.interrupts.t_interrupt)
+   -- Handle the pending lines of an EXTI interrupt. The pending lines that
+   -- belong to the same task and share the same user ISR are served by a
+   -- single ISR request, the ISR receiving the mask of these lines.
+   procedure handle_lines
+     (pending     : in  unsigned_32;
+      interrupt   : in  soc.interrupts.t_interrupt;
+      stamp       : in  unsigned_32)
    is
-      ref         : ewok.exported.gpios.t_gpio_ref;
-      conf        : ewok.exported.gpios.t_gpio_config_access;
-      task_id     : ewok.tasks_shared.t_task_id;
+      remaining   : unsigned_32 := pending;
+      others_mask : unsigned_32;
+      lines       : unsigned_32;
+      line        : soc.exti.t_exti_line_index;
+      other       : soc.exti.t_exti_line_index;
+      bit         : unsigned_32;
    begin
 
-      -- Clear the EXTI pending bit for this line
-      soc.exti.clear_pending (line);
-
-      -- Retrieve the configured GPIO point associated to this line
-      ref.pin  := t_gpio_pin_index'val (t_exti_line_index'pos (line));
-      soc.syscfg.get_exti_port
-        (ref.pin,   -- input
-         ref.port); -- output
-
-      -- Retrieving the GPIO configuration associated to that GPIO point.
-      -- Permit to get the "real" user ISR.
-      conf := ewok.gpio.get_config (ref);
-
-      if conf = NULL then
-         soc.nvic.clear_pending_irq (soc.nvic.to_irq_number (interrupt));
-         pragma DEBUG (debug.log (debug.ERROR, "unable to find GPIO informations for port" &
-            t_gpio_port_index'image (ref.port) & ", pin" &
-            t_gpio_pin_index'image (ref.pin)));
-      else
-         task_id  := ewok.gpio.get_task_id (ref);
-
-         ewok.isr.postpone_isr
-           (interrupt,
-            ewok.interrupts.to_handler_access (conf.all.exti_handler),
-            task_id);
-
-         -- if the EXTI line is configured as lockable by the kernel, the
-         -- EXTI line is disabled here, and must be unabled later by the
-         -- userspace using gpio_unlock_exti(). This permit to support
-         -- external devices that generates regular EXTI events which are
-         -- not correctly filtered
-         if conf.all.exti_lock = ewok.exported.gpios.GPIO_EXTI_LOCKED then
-            ewok.exti.disable(ref);
+      while remaining /= 0 loop
+
+         line := t_exti_line_index (m4.cpu.instructions.CTZ (remaining));
+
+         if exti_lines(line).task_id = ewok.tasks_shared.ID_UNUSED then
+            pragma DEBUG (debug.log (debug.ERROR,
+               "no task registered for EXTI line" &
+               t_exti_line_index'image (line)));
+            remaining := remaining and not shift_left (1, line);
+         else
+
+            -- Gathering the pending lines served by the same user ISR
+            lines       := 0;
+            others_mask := remaining;
+
+            while others_mask /= 0 loop
+               other := t_exti_line_index
+                          (m4.cpu.instructions.CTZ (others_mask));
+               bit   := shift_left (1, other);
+
+               if exti_lines(other).task_id = exti_lines(line).task_id and
+                  exti_lines(other).handler = exti_lines(line).handler
+               then
+                  lines := lines or bit;
+
+#if CONFIG_KERNEL_EXTI_TIMESTAMPS
+                  ewok.exti.push_timestamp (other, stamp);
+#end if;
+
+                  -- if the EXTI line is configured as lockable by the
+                  -- kernel, the EXTI line is disabled here, and must be
+                  -- unabled later by the userspace using gpio_unlock_exti().
+                  -- This permit to support external devices that generates
+                  -- regular EXTI events which are not correctly filtered
+                  if exti_lines(other).conf.all.exti_lock =
+                        ewok.exported.gpios.GPIO_EXTI_LOCKED
+                  then
+                     soc.exti.disable (other);
+                  end if;
+               end if;
+
+               others_mask := others_mask and not bit;
+            end loop;
+
+            -- The lines mask and the event timestamp are passed to the
+            -- user ISR
+            ewok.isr.postpone_exti_isr
+              (interrupt,
+               exti_lines(line).handler,
+               exti_lines(line).task_id,
+               lines,
+               stamp);
+
+            remaining := remaining and not lines;
          end if;
-      end if;
 
-   end handle_line;
+      end loop;
+
+   end handle_lines;
 
 
    procedure exti_handler
@@ -162,45 +192,50 @@ is
    is
       pragma unreferenced (frame_a);
       intr        : soc.interrupts.t_interrupt;
+      stamp       : unsigned_32;
+      pending     : unsigned_32;
    begin
 
-      intr := soc.interrupts.get_interrupt;
-
-      case intr is
-         when soc.interrupts.INT_EXTI0 =>
-            handle_line (0, intr);
+      -- Events timestamp, taken as early as possible
+      soc.dwt.get_cycles_32 (stamp);
 
-         when soc.interrupts.INT_EXTI1 =>
-            handle_line (1, intr);
-
-         when soc.interrupts.INT_EXTI2 =>
-            handle_line (2, intr);
-
-         when soc.interrupts.INT_EXTI3 =>
-            handle_line (3, intr);
+      intr := soc.interrupts.get_interrupt;
 
-         when soc.interrupts.INT_EXTI4 =>
-            handle_line (4, intr);
+      -- Reading the pending register once. Only the lines of the current
+      -- interrupt are handled.
+      pending := soc.exti.get_pending_lines;
 
+      case intr is
+         when soc.interrupts.INT_EXTI0       =>
+            pending := pending and 16#0001#;
+         when soc.interrupts.INT_EXTI1       =>
+            pending := pending and 16#0002#;
+         when soc.interrupts.INT_EXTI2       =>
+            pending := pending and 16#0004#;
+         when soc.interrupts.INT_EXTI3       =>
+            pending := pending and 16#0008#;
+         when soc.interrupts.INT_EXTI4       =>
+            pending := pending and 16#0010#;
          when soc.interrupts.INT_EXTI9_5     =>
-
-            for line in t_exti_line_index range 5 .. 9 loop
-               if soc.exti.is_line_pending (line) then
-                  handle_line (line, intr);
-               end if;
-            end loop;
-
+            pending := pending and 16#03E0#; -- lines 5 .. 9
          when soc.interrupts.INT_EXTI15_10   =>
-
-            for line in t_exti_line_index range 10 .. 15 loop
-               if soc.exti.is_line_pending (line) then
-                  handle_line (line, intr);
-               end if;
-            end loop;
-
+            pending := pending and 16#FC00#; -- lines 10 .. 15
          when others => raise program_error;
       end case;
 
+      -- Clear the EXTI pending bits of these lines and the NVIC pending bit
+      soc.exti.clear_pending_lines (pending);
+      soc.nvic.clear_pending_irq (soc.nvic.to_irq_number (intr));
+
+#if CONFIG_KERNEL_TRACE_EXTI
+      ewok.trace.event
+        (ewok.trace.TRACE_EXTI_LINES,
+         soc.interrupts.t_interrupt'pos (intr),
+         pending);
+#end if;
+
+      handle_lines (pending, intr, stamp);
+
    end exti_handler;
 
 end ewok.exti.handler;
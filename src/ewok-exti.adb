@@ -26,6 +26,7 @@ with soc.syscfg;
 with soc.gpio;
 with ewok.exported.gpios;   use ewok.exported.gpios;
 with ewok.exti.handler;
+with ewok.gpio;
 
 package body ewok.exti
    with spark_mode => off
@@ -135,6 +136,16 @@ is
       -- Configuring the SYSCFG register
       soc.syscfg.set_exti_port (conf.all.kref.pin, conf.all.kref.port);
 
+#if CONFIG_KERNEL_EXTI_TIMESTAMPS
+      p_exti_timestamps.init (exti_timestamps(line));
+#end if;
+
+      -- The GPIO has already been registered
+      exti_lines(line).task_id   := ewok.gpio.get_task_id (conf.all.kref);
+      exti_lines(line).conf      := ewok.gpio.get_config (conf.all.kref);
+      exti_lines(line).handler   :=
+         ewok.interrupts.to_handler_access (conf.all.exti_handler);
+
       exti_line_registered (line) := true;
       success := true;
 
@@ -157,6 +168,17 @@ is
          return;
       end if;
 
+      -- The line owner is cleared even if the line is disabled (locked),
+      -- so that no pending event is delivered to the releasing task
+      exti_lines(line) :=
+        (task_id  => ewok.tasks_shared.ID_UNUSED,
+         conf     => NULL,
+         handler  => NULL);
+
+#if CONFIG_KERNEL_EXTI_TIMESTAMPS
+      p_exti_timestamps.init (exti_timestamps(line));
+#end if;
+
       if not soc.exti.is_enabled (line) then
          return;
       end if;
@@ -172,4 +194,38 @@ is
    end release;
 
 
+#if CONFIG_KERNEL_EXTI_TIMESTAMPS
+
+   procedure push_timestamp
+     (line     : in  soc.exti.t_exti_line_index;
+      stamp    : in  unsigned_32)
+   is
+      ok : boolean;
+      pragma unreferenced (ok); -- If the ring is full, the event is lost
+   begin
+      p_exti_timestamps.write (exti_timestamps(line), stamp, ok);
+   end push_timestamp;
+
+
+   procedure get_timestamps
+     (ref      : in  ewok.exported.gpios.t_gpio_ref;
+      stamps   : out t_timestamp_list;
+      count    : out unsigned_32)
+   is
+      line : constant soc.exti.t_exti_line_index :=
+         soc.exti.t_exti_line_index'val
+           (soc.gpio.t_gpio_pin_index'pos (ref.pin));
+      ok   : boolean;
+   begin
+      count := 0;
+      for i in stamps'range loop
+         p_exti_timestamps.read (exti_timestamps(line), stamps(i), ok);
+         exit when not ok;
+         count := count + 1;
+      end loop;
+   end get_timestamps;
+
+#end if;
+
+
 end ewok.exti;
@@ -45,6 +45,14 @@ is
    end to_pin_alt_func;
 
 
+   function pin_mask
+     (pin : soc.gpio.t_gpio_pin_index) return unsigned_16
+   is
+   begin
+      return shift_left (1, soc.gpio.t_gpio_pin_index'pos (pin));
+   end pin_mask;
+
+
    function is_used
      (ref : ewok.exported.gpios.t_gpio_ref)
       return boolean
@@ -72,6 +80,8 @@ is
          gpio_points(ref.port, ref.pin).task_id    := task_id;
          gpio_points(ref.port, ref.pin).device_id  := device_id;
          gpio_points(ref.port, ref.pin).config     := conf_a;
+         owned_pins(task_id, ref.port) :=
+            owned_pins(task_id, ref.port) or pin_mask (ref.pin);
          success := true;
       end if;
    end register;
@@ -93,6 +103,8 @@ is
          gpio_points(ref.port, ref.pin).task_id    := ID_UNUSED;
          gpio_points(ref.port, ref.pin).device_id  := ID_DEV_UNUSED;
          gpio_points(ref.port, ref.pin).config     := NULL;
+         owned_pins(task_id, ref.port) :=
+            owned_pins(task_id, ref.port) and not pin_mask (ref.pin);
       end if;
    end release;
 
@@ -190,6 +202,30 @@ is
    end read_pin;
 
 
+   procedure write_pins
+     (port     : in  soc.gpio.t_gpio_port_index;
+      mask     : in  unsigned_16;
+      value    : in  unsigned_16)
+   is
+   begin
+      soc.gpio.write_pins
+        (port,
+         set   => value and mask,
+         reset => (not value) and mask);
+   end write_pins;
+
+
+   function read_pins
+     (port     : in  soc.gpio.t_gpio_port_index)
+      return unsigned_16
+   is
+      value : unsigned_16;
+   begin
+      soc.gpio.read_pins (port, value);
+      return value;
+   end read_pins;
+
+
    function belong_to
      (task_id     : ewok.tasks_shared.t_task_id;
       ref         : ewok.exported.gpios.t_gpio_ref)
@@ -206,6 +242,17 @@ is
    end belong_to;
 
 
+   function belong_to
+     (task_id     : ewok.tasks_shared.t_task_id;
+      port        : soc.gpio.t_gpio_port_index;
+      mask        : unsigned_16)
+      return boolean
+   is
+   begin
+      return (mask and not owned_pins(task_id, port)) = 0;
+   end belong_to;
+
+
    function get_task_id
      (ref      : in  ewok.exported.gpios.t_gpio_ref)
       return ewok.tasks_shared.t_task_id
@@ -0,0 +1,242 @@
+--
+-- Copyright 2018 The wookey project team <wookey@ssi.gouv.fr>
+--   - Ryad     Benadjila
+--   - Arnauld  Michelizza
+--   - Mathieu  Renard
+--   - Philippe Thierry
+--   - Philippe Trebuchet
+--
+-- Licensed under the Apache License, Version 2.0 (the "License");
+-- you may not use this file except in compliance with the License.
+-- You may obtain a copy of the License at
+--
+--     http://www.apache.org/licenses/LICENSE-2.0
+--
+--     Unless required by applicable law or agreed to in writing, software
+--     distributed under the License is distributed on an "AS IS" BASIS,
+--     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+--     See the License for the specific language governing permissions and
+--     limitations under the License.
+--
+--
+
+
+#if CONFIG_KERNEL_ALARM_HRTIMER
+with m4.cpu;
+with ewok.interrupts;
+with ewok.debug;
+with ewok.softirq;
+#if CONFIG_KERNEL_BENCH
+with ewok.bench;
+#end if;
+with ewok.tasks_shared;
+with ewok.devices_shared;
+with soc.interrupts;
+with soc.nvic;
+with soc.tim;
+#end if;
+
+package body ewok.hralarm
+   with spark_mode => off
+is
+
+#if CONFIG_KERNEL_ALARM_HRTIMER
+   TIMER_FREQUENCY : constant := 1_000_000; -- Hz
+
+   type t_hralarm is record
+      deadline : unsigned_32;    -- Timer counter value
+      period   : unsigned_32;    -- 0 for a one-shot alarm
+      handler  : system_address; -- 0 if the alarm is not set
+   end record;
+
+   alarms : array (t_real_task_id) of t_hralarm :=
+      (others => (deadline => 0, period => 0, handler => 0));
+
+
+   -- The counter wraps: a deadline is reached if it is less than 2^31
+   -- ticks behind the counter
+   function is_reached
+     (deadline : unsigned_32;
+      now      : unsigned_32)
+      return boolean
+   is (now - deadline < 2**31);
+
+
+   -- Deliver the reached alarms through the softirq and compute their
+   -- next deadline
+   procedure deliver
+     (now      : in  unsigned_32)
+   is
+      ok       : boolean;
+   begin
+      for id in alarms'range loop
+         if alarms(id).handler /= 0 and then
+            is_reached (alarms(id).deadline, now)
+         then
+
+            -- A task has at most one pending occurrence: an occurrence
+            -- not yet delivered is replaced by the new one. When the
+            -- softirq queue is full, the occurrence is dropped.
+            ewok.softirq.push_soft_coalesced
+              (id, (alarms(id).handler, now, alarms(id).deadline, 0), ok);
+            if not ok then
+               pragma DEBUG (debug.log (debug.WARNING,
+                  "hralarm: softirq queue full, alarm dropped"));
+#if CONFIG_KERNEL_BENCH
+            else
+               ewok.bench.start_wakeup (id, ewok.bench.BENCH_ALARM_WAKEUP);
+#end if;
+            end if;
+
+            if alarms(id).period = 0 then
+               alarms(id) := (deadline => 0, period => 0, handler => 0);
+            else
+               -- No drift: the next deadline only depends on the previous
+               -- one. Missed periods are skipped.
+               loop
+                  alarms(id).deadline :=
+                     alarms(id).deadline + alarms(id).period;
+                  exit when not is_reached (alarms(id).deadline, now);
+               end loop;
+            end if;
+
+         end if;
+      end loop;
+   end deliver;
+
+
+   -- Deliver the reached alarms and program the compare channel with the
+   -- nearest deadline. Must be called with interrupts disabled.
+   procedure update
+   is
+      now      : unsigned_32;
+      next     : unsigned_32;
+      found    : boolean;
+   begin
+      loop
+         now   := soc.tim.get_counter;
+         deliver (now);
+
+         found := false;
+         next  := 0;
+         for id in alarms'range loop
+            if alarms(id).handler /= 0 and then
+               (not found or else
+                alarms(id).deadline - now < next - now)
+            then
+               next  := alarms(id).deadline;
+               found := true;
+            end if;
+         end loop;
+
+         if not found then
+            soc.tim.disable_compare;
+            return;
+         end if;
+
+         soc.tim.set_compare (next);
+
+         -- The compare event is lost if the deadline has been reached
+         -- while being programmed
+         exit when not is_reached (next, soc.tim.get_counter);
+      end loop;
+   end update;
+
+
+   procedure hralarm_handler
+     (frame_a : in ewok.t_stack_frame_access)
+   is
+      pragma unreferenced (frame_a);
+      primask  : constant unsigned_32 := m4.cpu.get_primask_register;
+   begin
+      -- push_soft() is not reentrant (systick)
+      m4.cpu.disable_irq;
+      soc.tim.clear_compare_flag;
+      update;
+      m4.cpu.set_primask_register (primask);
+   end hralarm_handler;
+
+
+   procedure set_alarm
+     (task_id        : in  t_real_task_id;
+      delay_us       : in  unsigned_32;
+      period_us      : in  unsigned_32;
+      handler        : in  system_address)
+   is
+      primask  : constant unsigned_32 := m4.cpu.get_primask_register;
+   begin
+      m4.cpu.disable_irq;
+      alarms(task_id) :=
+        (deadline => soc.tim.get_counter + delay_us,
+         period   => period_us,
+         handler  => handler);
+      update;
+      m4.cpu.set_primask_register (primask);
+   end set_alarm;
+
+
+   procedure unset_alarm
+     (task_id        : in  t_real_task_id)
+   is
+      primask  : constant unsigned_32 := m4.cpu.get_primask_register;
+   begin
+      m4.cpu.disable_irq;
+      alarms(task_id) := (deadline => 0, period => 0, handler => 0);
+      update;
+      m4.cpu.set_primask_register (primask);
+   end unset_alarm;
+
+
+   procedure init
+   is
+      ok : boolean;
+   begin
+
+      soc.tim.init (TIMER_FREQUENCY);
+
+      ewok.interrupts.set_interrupt_handler
+        (soc.interrupts.INT_TIM5,
+         hralarm_handler'access,
+         ewok.tasks_shared.ID_KERNEL,
+         ewok.devices_shared.ID_DEV_UNUSED,
+         ok);
+
+      if not ok then raise program_error; end if;
+
+      soc.nvic.enable_irq
+        (soc.nvic.to_irq_number (soc.interrupts.INT_TIM5));
+
+   end init;
+
+#else
+
+   procedure set_alarm
+     (task_id        : in  t_real_task_id;
+      delay_us       : in  unsigned_32;
+      period_us      : in  unsigned_32;
+      handler        : in  system_address)
+   is
+      pragma unreferenced (task_id, delay_us, period_us, handler);
+   begin
+      null;
+   end set_alarm;
+
+
+   procedure unset_alarm
+     (task_id        : in  t_real_task_id)
+   is
+      pragma unreferenced (task_id);
+   begin
+      null;
+   end unset_alarm;
+
+
+   procedure init
+   is
+   begin
+      null;
+   end init;
+
+#end if;
+
+end ewok.hralarm;
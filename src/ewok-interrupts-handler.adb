@@ -31,6 +31,14 @@ with ewok.sched;
 with ewok.tasks_shared;    use ewok.tasks_shared;
 with ewok.devices_shared;  use type ewok.devices_shared.t_device_id;
 with ewok.isr;
+#if CONFIG_KERNEL_BENCH
+with ewok.bench;
+with ewok.cycles;
+#else
+#if CONFIG_KERNEL_ISR_LATENCY_STATS
+with ewok.cycles;
+#end if;
+#end if;
 
 
 package body ewok.interrupts.handler
@@ -81,9 +89,16 @@ is
      (frame_a : t_stack_frame_access)
       return t_stack_frame_access
    is
+#if CONFIG_KERNEL_ISR_LATENCY_STATS
+      -- Interrupt dispatching is part of the measured latency
+      entry_stamp : constant unsigned_32 := ewok.cycles.get_cycles;
+#end if;
       it          : t_interrupt;
       new_frame_a : t_stack_frame_access;
       ttype       : t_task_type;
+#if CONFIG_KERNEL_BENCH
+      stamp       : constant unsigned_32 := ewok.cycles.get_cycles;
+#end if;
    begin
 
       it := soc.interrupts.get_interrupt;
@@ -97,6 +112,9 @@ is
          if it < INT_WWDG then
             if interrupt_table(it).task_id = ewok.tasks_shared.ID_KERNEL then
                new_frame_a := interrupt_table(it).task_switch_handler (frame_a);
+#if CONFIG_KERNEL_BENCH
+               ewok.bench.account (it, stamp);
+#end if;
             else
                debug.panic ("Unhandled exception " & t_interrupt'image (it));
             end if;
@@ -112,8 +130,14 @@ is
                ewok.isr.postpone_isr
                  (it,
                   interrupt_table(it).handler,
+#if CONFIG_KERNEL_ISR_LATENCY_STATS
+                  entry_stamp,
+#end if;
                   interrupt_table(it).task_id);
                new_frame_a := ewok.sched.do_schedule (frame_a);
+#if CONFIG_KERNEL_BENCH
+               ewok.bench.account_user_irq (stamp);
+#end if;
             else
                pragma DEBUG (debug.log (debug.ALERT,
                   "Unhandled interrupt " & t_interrupt'image (it)));
@@ -171,6 +195,9 @@ is
                ewok.isr.postpone_isr
                  (it,
                   interrupt_table(it).handler,
+#if CONFIG_KERNEL_ISR_LATENCY_STATS
+                  entry_stamp,
+#end if;
                   interrupt_table(it).task_id);
             else
                pragma DEBUG (debug.log (debug.ALERT,
@@ -25,6 +25,9 @@ with ewok.tasks_shared;    use ewok.tasks_shared;
 with ewok.devices_shared;  use ewok.devices_shared;
 with m4.scb;
 with soc.nvic;
+#if CONFIG_KERNEL_ISR_LATENCY_STATS
+with ewok.latency;
+#end if;
 
 package body ewok.interrupts
    with spark_mode => off
@@ -42,7 +45,9 @@ is
            (htype     => DEFAULT_HANDLER,
             handler   => NULL,
             task_id   => ewok.tasks_shared.ID_UNUSED,
-            device_id => ewok.devices_shared.ID_DEV_UNUSED);
+            device_id => ewok.devices_shared.ID_DEV_UNUSED,
+            config    => NULL,
+            posthook  => NULL);
       end loop;
 
       interrupt_table(soc.interrupts.INT_HARDFAULT) :=
@@ -50,28 +55,36 @@ is
             task_switch_handler =>
                ewok.interrupts.handler.hardfault_handler'access,
             task_id   => ewok.tasks_shared.ID_KERNEL,
-            device_id => ewok.devices_shared.ID_DEV_UNUSED);
+            device_id => ewok.devices_shared.ID_DEV_UNUSED,
+            config    => NULL,
+            posthook  => NULL);
 
       interrupt_table(soc.interrupts.INT_BUSFAULT) :=
            (htype     => TASK_SWITCH_HANDLER,
             task_switch_handler =>
                ewok.interrupts.handler.busfault_handler'access,
             task_id   => ewok.tasks_shared.ID_KERNEL,
-            device_id => ewok.devices_shared.ID_DEV_UNUSED);
+            device_id => ewok.devices_shared.ID_DEV_UNUSED,
+            config    => NULL,
+            posthook  => NULL);
 
       interrupt_table(soc.interrupts.INT_USAGEFAULT) :=
            (htype     => TASK_SWITCH_HANDLER,
             task_switch_handler =>
                ewok.interrupts.handler.usagefault_handler'access,
             task_id   => ewok.tasks_shared.ID_KERNEL,
-            device_id => ewok.devices_shared.ID_DEV_UNUSED);
+            device_id => ewok.devices_shared.ID_DEV_UNUSED,
+            config    => NULL,
+            posthook  => NULL);
 
       interrupt_table(soc.interrupts.INT_SYSTICK) :=
            (htype     => TASK_SWITCH_HANDLER,
             task_switch_handler =>
                ewok.interrupts.handler.systick_default_handler'access,
             task_id   => ewok.tasks_shared.ID_KERNEL,
-            device_id => ewok.devices_shared.ID_DEV_UNUSED);
+            device_id => ewok.devices_shared.ID_DEV_UNUSED,
+            config    => NULL,
+            posthook  => NULL);
 
       m4.scb.SCB.SHPR1.mem_fault.priority := 0;
       m4.scb.SCB.SHPR1.bus_fault.priority := 1;
@@ -109,13 +122,29 @@ is
       end if;
 
       interrupt_table(interrupt) :=
-        (DEFAULT_HANDLER, task_id, device_id, handler);
+        (DEFAULT_HANDLER, task_id, device_id, NULL, NULL, handler);
+
+#if CONFIG_KERNEL_ISR_LATENCY_STATS
+      -- Statistics of a previous owner are dropped
+      ewok.latency.release (interrupt);
+#end if;
 
       success := true;
 
    end set_interrupt_handler;
 
 
+   procedure set_interrupt_config
+     (interrupt   : in  soc.interrupts.t_interrupt;
+      config      : access ewok.exported.interrupts.t_interrupt_config;
+      posthook    : access ewok.posthook.t_program)
+   is
+   begin
+      interrupt_table(interrupt).config   := config;
+      interrupt_table(interrupt).posthook := posthook;
+   end set_interrupt_config;
+
+
    procedure reset_interrupt_handler
      (interrupt   : in  soc.interrupts.t_interrupt;
       task_id     : in  ewok.tasks_shared.t_task_id;
@@ -132,6 +161,12 @@ is
       interrupt_table(interrupt).handler     := NULL;
       interrupt_table(interrupt).task_id     := ID_UNUSED;
       interrupt_table(interrupt).device_id   := ID_DEV_UNUSED;
+      interrupt_table(interrupt).config      := NULL;
+      interrupt_table(interrupt).posthook    := NULL;
+
+#if CONFIG_KERNEL_ISR_LATENCY_STATS
+      ewok.latency.release (interrupt);
+#end if;
 
    end reset_interrupt_handler;
 
@@ -150,7 +185,7 @@ is
       end if;
 
       interrupt_table(interrupt) :=
-        (TASK_SWITCH_HANDLER, task_id, device_id, handler);
+        (TASK_SWITCH_HANDLER, task_id, device_id, NULL, NULL, handler);
 
       success := true;
 
@@ -22,6 +22,7 @@
 
 
 with ada.unchecked_conversion;
+with ewok.memops;
 
 package body ewok.ipc
    with spark_mode => off
@@ -69,9 +70,8 @@ is
       ep.to    := ewok.ipc.ID_UNUSED;
       ep.state := FREE;
       ep.size  := 0;
-      for i in ep.data'range loop
-         ep.data(i)  := 0;
-      end loop;
+      ewok.memops.fill
+        (to_system_address (ep.data'address), 0, ep.data'length);
    end init_endpoint;
 
 
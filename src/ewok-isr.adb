@@ -24,17 +24,47 @@ with soc.interrupts; use soc.interrupts;
 with ewok.posthook;
 with ewok.softirq;
 with ewok.dma;
-with soc.dma;
+with soc.dma;         use type soc.dma.t_current_target;
 with soc.nvic;
+#if CONFIG_KERNEL_DMA_PROFILING
+with ewok.cycles;
+#else
+#if CONFIG_KERNEL_ISR_LATENCY_STATS
+with ewok.cycles;
+#end if;
+#end if;
+#if CONFIG_KERNEL_DMA_PROFILING
+with ewok.dma.stats;
+#end if;
+#if CONFIG_KERNEL_ISR_LATENCY_STATS
+with ewok.latency;
+with ewok.exported.latency;
+#end if;
+#if CONFIG_KERNEL_TRACE_DMA
+with ewok.trace;
+#else
+#if CONFIG_KERNEL_TRACE_DEVICES
+with ewok.trace;
+#end if;
+#end if;
+#if CONFIG_KERNEL_ISR_COALESCING
+with ewok.devices;
+with ewok.exported.interrupts;
+   use type ewok.exported.interrupts.t_interrupt_config_access;
+   use type ewok.exported.interrupts.t_isr_coalescing;
+#end if;
 
 package body ewok.isr
    with spark_mode => off
 is
 
    procedure postpone_isr
-     (intr     : in soc.interrupts.t_interrupt;
-      handler  : in ewok.interrupts.t_interrupt_handler_access;
-      task_id  : in ewok.tasks_shared.t_task_id)
+     (intr        : in soc.interrupts.t_interrupt;
+      handler     : in ewok.interrupts.t_interrupt_handler_access;
+#if CONFIG_KERNEL_ISR_LATENCY_STATS
+      entry_stamp : in unsigned_32;
+#end if;
+      task_id     : in ewok.tasks_shared.t_task_id)
    is
 
       pragma warnings (off); -- Size differ
@@ -43,10 +73,17 @@ is
       pragma warnings (on);
 
       dma_status  : soc.dma.t_dma_stream_int_status;
+      dma_target  : soc.dma.t_current_target;
       status      : unsigned_32 := 0;
       data        : unsigned_32 := 0;
       isr_params  : ewok.softirq.t_isr_parameters;
       ok          : boolean;
+#if CONFIG_KERNEL_DMA_CHAINS
+      pending     : boolean;
+#end if;
+#if CONFIG_KERNEL_DMA_PROFILING
+      dma_stamp   : constant unsigned_32 := ewok.cycles.get_cycles;
+#end if;
    begin
 
       -- Acknowledge interrupt:
@@ -60,13 +97,37 @@ is
       --   value (former 'status' and 'data' parameters)
 
       if soc.dma.soc_is_dma_irq (intr) then
-         ewok.dma.get_status_register (task_id, intr, dma_status, ok);
+         ewok.dma.get_status_register
+           (task_id, intr, dma_status, dma_target, ok);
          if ok then
             status := to_unsigned_32 (dma_status) and 2#0011_1101#;
+            -- Double buffer mode: memory 1 is the current target
+            if dma_target = soc.dma.MEMORY_1 then
+               status := status or 2#0100_0000#;
+            end if;
          else
             raise program_error;
          end if;
          ewok.dma.clear_dma_interrupts (task_id, intr);
+
+#if CONFIG_KERNEL_DMA_PROFILING
+         ewok.dma.stats.account_status (intr, dma_status);
+#end if;
+
+#if CONFIG_KERNEL_DMA_CHAINS
+         -- Scatter-gather chain: the next segment is started by the
+         -- kernel. The task is notified only at the end of the chain or
+         -- on error.
+         ewok.dma.continue_chain (task_id, intr, dma_status, pending);
+         if pending then
+            soc.nvic.clear_pending_irq (soc.nvic.to_irq_number (intr));
+#if CONFIG_KERNEL_DMA_PROFILING
+            ewok.dma.stats.account
+              (ewok.dma.stats.OP_CHAIN_SEGMENT, dma_stamp);
+#end if;
+            return;
+         end if;
+#end if;
       else
          -- INFO: this function should be executed as a critical section
          -- (ToCToU risk)
@@ -76,17 +137,90 @@ is
       -- All user ISR have their Pending IRQ bit clean here
       soc.nvic.clear_pending_irq (soc.nvic.to_irq_number (intr));
 
+#if CONFIG_KERNEL_TRACE_DMA
+      if soc.dma.soc_is_dma_irq (intr) then
+         ewok.trace.event
+           (ewok.trace.TRACE_DMA_IRQ,
+            soc.interrupts.t_interrupt'pos (intr),
+            ewok.tasks_shared.to_unsigned_32 (task_id),
+            status);
+      end if;
+#end if;
+#if CONFIG_KERNEL_TRACE_DEVICES
+      if not soc.dma.soc_is_dma_irq (intr) then
+         ewok.trace.event
+           (ewok.trace.TRACE_DEV_IRQ,
+            soc.interrupts.t_interrupt'pos (intr),
+            ewok.tasks_shared.to_unsigned_32 (task_id),
+            status);
+      end if;
+#end if;
+
       -- Pushing the request for further treatment by softirq
       isr_params.handler          := ewok.interrupts.to_system_address (handler);
       isr_params.interrupt        := intr;
       isr_params.posthook_status  := status;
       isr_params.posthook_data    := data;
 
+#if CONFIG_KERNEL_ISR_LATENCY_STATS
+      ewok.latency.account
+        (intr, ewok.exported.latency.LAT_POSTHOOK, entry_stamp);
+      isr_params.entry_stamp      := entry_stamp;
+      isr_params.posthook_stamp   := ewok.cycles.get_cycles;
+#end if;
+
+#if CONFIG_KERNEL_ISR_COALESCING
+      declare
+         config_a : constant ewok.exported.interrupts.t_interrupt_config_access
+            := ewok.devices.get_interrupt_config_from_interrupt (intr);
+      begin
+         if config_a /= NULL and then
+            config_a.all.coalescing = ewok.exported.interrupts.ISR_COALESCING
+         then
+            ewok.softirq.push_isr_coalesced (task_id, isr_params);
+            return;
+         end if;
+      end;
+#end if;
+
       -- INFO: this function is not reentrant
       ewok.softirq.push_isr (task_id, isr_params);
 
+#if CONFIG_KERNEL_DMA_PROFILING
+      if soc.dma.soc_is_dma_irq (intr) then
+         ewok.dma.stats.account (ewok.dma.stats.OP_INTERRUPT, dma_stamp);
+      end if;
+#end if;
+
       return;
 
    end postpone_isr;
 
+
+   procedure postpone_exti_isr
+     (intr     : in soc.interrupts.t_interrupt;
+      handler  : in ewok.interrupts.t_interrupt_handler_access;
+      task_id  : in ewok.tasks_shared.t_task_id;
+      lines    : in unsigned_32;
+      stamp    : in unsigned_32)
+   is
+      isr_params  : ewok.softirq.t_isr_parameters;
+   begin
+
+      isr_params.handler          := ewok.interrupts.to_system_address (handler);
+      isr_params.interrupt        := intr;
+      isr_params.posthook_status  := lines;
+      isr_params.posthook_data    := stamp;
+
+#if CONFIG_KERNEL_ISR_LATENCY_STATS
+      ewok.latency.account
+        (intr, ewok.exported.latency.LAT_POSTHOOK, stamp);
+      isr_params.entry_stamp      := stamp;
+      isr_params.posthook_stamp   := ewok.cycles.get_cycles;
+#end if;
+
+      ewok.softirq.push_isr (task_id, isr_params);
+
+   end postpone_exti_isr;
+
 end ewok.isr;
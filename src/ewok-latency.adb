@@ -0,0 +1,133 @@
+--
+-- Copyright 2018 The wookey project team <wookey@ssi.gouv.fr>
+--   - Ryad     Benadjila
+--   - Arnauld  Michelizza
+--   - Mathieu  Renard
+--   - Philippe Thierry
+--   - Philippe Trebuchet
+--
+-- Licensed under the Apache License, Version 2.0 (the "License");
+-- you may not use this file except in compliance with the License.
+-- You may obtain a copy of the License at
+--
+--     http://www.apache.org/licenses/LICENSE-2.0
+--
+--     Unless required by applicable law or agreed to in writing, software
+--     distributed under the License is distributed on an "AS IS" BASIS,
+--     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+--     See the License for the specific language governing permissions and
+--     limitations under the License.
+--
+--
+
+with ewok.cycles;
+with soc.interrupts;   use type soc.interrupts.t_interrupt;
+
+package body ewok.latency
+   with spark_mode => off
+is
+
+   EMPTY_STATS : constant t_latency_stats :=
+     (others => (hist => (others => 0), max => 0));
+
+
+   function get_bucket (cycles : unsigned_32) return natural
+   is
+      bucket : natural     := 0;
+      val    : unsigned_32 := shift_right (cycles, 1);
+   begin
+      while val /= 0 and bucket < HIST_BUCKETS - 1 loop
+         bucket := bucket + 1;
+         val    := shift_right (val, 1);
+      end loop;
+      return bucket;
+   end get_bucket;
+
+
+   procedure get_entry
+     (intr     : in  soc.interrupts.t_interrupt;
+      id       : out t_latency_id)
+   is
+   begin
+      id := entries(intr);
+      if id /= ID_LAT_UNUSED then
+         return;
+      end if;
+
+      for i in latencies'range loop
+         if latencies(i).intr = soc.interrupts.INT_NONE then
+            latencies(i).intr  := intr;
+            latencies(i).stats := EMPTY_STATS;
+            entries(intr)      := i;
+            id := i;
+            return;
+         end if;
+      end loop;
+   end get_entry;
+
+
+   procedure account
+     (intr     : in  soc.interrupts.t_interrupt;
+      stage    : in  t_latency_stage;
+      start    : in  unsigned_32)
+   is
+      cycles   : constant unsigned_32 := ewok.cycles.elapsed (start);
+      id       : t_latency_id;
+      bucket   : natural;
+   begin
+
+      get_entry (intr, id);
+      if id = ID_LAT_UNUSED then
+         return; -- No more entry available
+      end if;
+
+      declare
+         stats : t_stage_stats renames latencies(id).stats(stage);
+      begin
+         bucket := get_bucket (cycles);
+         if stats.hist(bucket) /= unsigned_16'last then
+            stats.hist(bucket) := stats.hist(bucket) + 1;
+         end if;
+
+         if cycles > stats.max then
+            stats.max := cycles;
+         end if;
+      end;
+
+   end account;
+
+
+   procedure get_stats
+     (intr     : in  soc.interrupts.t_interrupt;
+      stats    : out t_latency_stats)
+   is
+   begin
+      if entries(intr) = ID_LAT_UNUSED then
+         stats := EMPTY_STATS;
+      else
+         stats := latencies(entries(intr)).stats;
+      end if;
+   end get_stats;
+
+
+   procedure reset_stats
+     (intr     : in  soc.interrupts.t_interrupt)
+   is
+   begin
+      if entries(intr) /= ID_LAT_UNUSED then
+         latencies(entries(intr)).stats := EMPTY_STATS;
+      end if;
+   end reset_stats;
+
+
+   procedure release
+     (intr     : in  soc.interrupts.t_interrupt)
+   is
+   begin
+      if entries(intr) /= ID_LAT_UNUSED then
+         latencies(entries(intr)).intr := soc.interrupts.INT_NONE;
+         entries(intr) := ID_LAT_UNUSED;
+      end if;
+   end release;
+
+end ewok.latency;
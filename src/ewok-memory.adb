@@ -26,7 +26,9 @@ with ada.unchecked_conversion;
 with ewok.devices_shared;  use ewok.devices_shared;
 with ewok.tasks;           use type ewok.tasks.t_task_type;
 with ewok.devices;
+#if not CONFIG_KERNEL_ISR_PER_TASK_STACK
 with ewok.layout;
+#end if;
 with ewok.mpu;
 with ewok.mpu.allocator;
 with ewok.debug;
@@ -127,9 +129,21 @@ is
    procedure unmap_device
      (dev_id   : in  ewok.devices_shared.t_registered_device_id)
    is
+      region_type : ewok.mpu.t_region_type;
    begin
+
+      if ewok.devices.is_device_region_ro (dev_id) then
+         region_type := ewok.mpu.REGION_TYPE_USER_DEV_RO;
+      else
+         region_type := ewok.mpu.REGION_TYPE_USER_DEV;
+      end if;
+
       ewok.mpu.allocator.unmap_from_pool
-        (ewok.devices.get_device_addr (dev_id));
+        (addr           => ewok.devices.get_device_addr (dev_id),
+         size           => ewok.devices.get_device_size (dev_id),
+         region_type    => region_type,
+         subregion_mask => ewok.devices.get_device_subregions_mask (dev_id));
+
    end unmap_device;
 
 
@@ -140,10 +154,29 @@ is
    end unmap_all_devices;
 
 
-   function device_can_be_mapped return boolean
+   function device_can_be_mapped
+     (periph_id : soc.devmap.t_periph_id)
+      return boolean
    is
+      region_type : ewok.mpu.t_region_type;
    begin
-      return ewok.mpu.allocator.free_region_exist;
+      if periph_id = soc.devmap.NO_PERIPH then
+         return ewok.mpu.allocator.free_region_exist;
+      end if;
+
+      if soc.devmap.periphs(periph_id).ro then
+         region_type := ewok.mpu.REGION_TYPE_USER_DEV_RO;
+      else
+         region_type := ewok.mpu.REGION_TYPE_USER_DEV;
+      end if;
+
+      -- The device may be coalesced with an already mapped device
+      return ewok.mpu.allocator.can_be_mapped
+        (addr           => soc.devmap.periphs(periph_id).addr,
+         size           => soc.devmap.periphs(periph_id).size,
+         region_type    => region_type,
+         subregion_mask => m4.mpu.to_subregion_mask
+                             (soc.devmap.periphs(periph_id).subregions));
    end device_can_be_mapped;
 
 
@@ -166,9 +199,12 @@ is
       end if;
 
       -- Mapping ISR device and ISR stack
-      if new_task.mode = TASK_MODE_ISRTHREAD then
+      if ewok.tasks.tasks_mode(id) = TASK_MODE_ISRTHREAD then
 
+#if not CONFIG_KERNEL_ISR_PER_TASK_STACK
          -- Mapping the ISR stack
+         -- Note - per-task ISR stacks are part of the task's RAM slots,
+         --        mapped with its data by map_code_and_data()
          ewok.mpu.allocator.map_in_pool
            (addr           => ewok.layout.STACK_BOTTOM_TASK_ISR,
             size           => 4096,
@@ -179,6 +215,7 @@ is
          if not ok then
             debug.panic ("mpu_isr(): mapping ISR stack failed!");
          end if;
+#end if;
 
          -- Mapping the ISR device
          dev_id := new_task.isr_ctx.device_id;
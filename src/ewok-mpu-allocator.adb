@@ -64,6 +64,92 @@ is
    end to_next_power_of_2;
 
 
+   function is_coalescable
+     (size           : unsigned_32;
+      region_type    : ewok.mpu.t_region_type;
+      subregion_mask : m4.mpu.t_subregion_mask)
+      return boolean
+   is
+      use type m4.mpu.t_subregion_mask;
+   begin
+      return
+        (region_type = ewok.mpu.REGION_TYPE_USER_DEV or
+         region_type = ewok.mpu.REGION_TYPE_USER_DEV_RO)
+        and size >= 32 and size <= 256*MBYTE
+        and is_power_of_2 (size)
+        and subregion_mask = (subregion_mask'range => m4.mpu.SUB_REGION_ENABLED);
+   end is_coalescable;
+
+
+   -- Window of a coalescable device and its subregion in that window
+   procedure get_window
+     (addr           : in  system_address;
+      size           : in  unsigned_32;
+      window_addr    : out system_address;
+      window_size    : out unsigned_32;
+      subregion      : out m4.mpu.t_subregion_range)
+   is
+   begin
+      window_size := 8 * size;
+      window_addr := addr and not (window_size - 1);
+      subregion   := m4.mpu.t_subregion_range ((addr - window_addr) / size + 1);
+   end get_window;
+
+
+   -- Region with the same window and the same type than the device
+   procedure find_window
+     (window_addr    : in  system_address;
+      window_size    : in  unsigned_32;
+      region_type    : in  ewok.mpu.t_region_type;
+      region         : out m4.mpu.t_region_number;
+      success        : out boolean)
+   is
+      use type ewok.mpu.t_region_type;
+   begin
+      for r in regions_pool'range loop
+         if regions_pool(r).used                         and
+            regions_pool(r).coalescable                  and
+            regions_pool(r).addr          = window_addr  and
+            regions_pool(r).size          = window_size  and
+            regions_pool(r).region_type   = region_type
+         then
+            region   := r;
+            success  := true;
+            return;
+         end if;
+      end loop;
+      region   := regions_pool'first;
+      success  := false;
+   end find_window;
+
+
+   function can_be_mapped
+     (addr           : system_address;
+      size           : unsigned_32;
+      region_type    : ewok.mpu.t_region_type;
+      subregion_mask : m4.mpu.t_subregion_mask)
+      return boolean
+   is
+      window_addr : system_address;
+      window_size : unsigned_32;
+      subregion   : m4.mpu.t_subregion_range;
+      region      : m4.mpu.t_region_number;
+      found       : boolean;
+   begin
+      if free_region_exist then
+         return true;
+      end if;
+
+      if not is_coalescable (size, region_type, subregion_mask) then
+         return false;
+      end if;
+
+      get_window (addr, size, window_addr, window_size, subregion);
+      find_window (window_addr, window_size, region_type, region, found);
+      return found;
+   end can_be_mapped;
+
+
    procedure map_in_pool
      (addr           : in  system_address;
       size           : in  unsigned_32; -- in bytes
@@ -73,6 +159,12 @@ is
    is
       region_size    : m4.mpu.t_region_size;
       allocated_size : unsigned_32;
+      region_addr    : system_address;
+      region_mask    : m4.mpu.t_subregion_mask;
+      coalescable    : boolean;
+      subregion      : m4.mpu.t_subregion_range;
+      region         : m4.mpu.t_region_number;
+      found          : boolean;
    begin
 
       -- Verifying size's bounds
@@ -83,27 +175,68 @@ is
          return;
       end if;
 
-      -- Verifying that size is a power of 2
-      if not is_power_of_2 (size)
-      then
-         allocated_size := to_next_power_of_2 (size);
+      coalescable := is_coalescable (size, region_type, subregion_mask);
+
+      if coalescable then
+
+         get_window (addr, size, region_addr, allocated_size, subregion);
+
+         -- Verifying device alignement
+         if (unsigned_32 (addr) and (size - 1)) > 0 then
+            success := false;
+            return;
+         end if;
+
+         -- Is the window already mapped? The device's subregion is
+         -- simply enabled.
+         find_window
+           (region_addr, allocated_size, region_type, region, found);
+
+         if found then
+            regions_pool(region).mask(subregion) := m4.mpu.SUB_REGION_ENABLED;
+            ewok.mpu.update_subregions (region, regions_pool(region).mask);
+            success := true;
+            pragma assume (is_in_pool (addr));
+            return;
+         end if;
+
+         region_mask := (others => m4.mpu.SUB_REGION_DISABLED);
+         region_mask(subregion) := m4.mpu.SUB_REGION_ENABLED;
+
       else
-         allocated_size := size;
-      end if;
 
-      -- Verifying region alignement
-      if (unsigned_32 (addr) and (allocated_size - 1)) > 0 then
-         success := false;
-         return;
+         -- Verifying that size is a power of 2
+         if not is_power_of_2 (size)
+         then
+            allocated_size := to_next_power_of_2 (size);
+         else
+            allocated_size := size;
+         end if;
+
+         -- Verifying region alignement
+         if (unsigned_32 (addr) and (allocated_size - 1)) > 0 then
+            success := false;
+            return;
+         end if;
+
+         region_addr := addr;
+         region_mask := subregion_mask;
+
       end if;
 
       ewok.mpu.bytes_to_region_size (allocated_size, region_size);
 
-      for region in regions_pool'range loop
-         if not regions_pool(region).used then
-            regions_pool(region) := (used => true, addr => addr);
+      for r in regions_pool'range loop
+         if not regions_pool(r).used then
+            regions_pool(r) :=
+              (used        => true,
+               addr        => region_addr,
+               size        => allocated_size,
+               region_type => region_type,
+               mask        => region_mask,
+               coalescable => coalescable);
             ewok.mpu.set_region
-              (region, addr, region_size, region_type, subregion_mask);
+              (r, region_addr, region_size, region_type, region_mask);
             success := true;
             pragma assume (is_in_pool (addr));
             return;
@@ -115,19 +248,70 @@ is
    end map_in_pool;
 
 
+   procedure free_region
+     (region   : in  m4.mpu.t_region_number)
+   is
+   begin
+      m4.mpu.disable_region (region);
+      regions_pool(region).used        := false;
+      regions_pool(region).addr        := 0;
+      regions_pool(region).size        := 0;
+      regions_pool(region).mask        := (others => m4.mpu.SUB_REGION_DISABLED);
+      regions_pool(region).coalescable := false;
+   end free_region;
+
+
    procedure unmap_from_pool
-     (addr     : in  system_address)
+     (addr           : in  system_address;
+      size           : in  unsigned_32;
+      region_type    : in  ewok.mpu.t_region_type;
+      subregion_mask : in  m4.mpu.t_subregion_mask)
    is
+      use type m4.mpu.t_subregion_mask;
+      window_addr : system_address;
+      window_size : unsigned_32;
+      subregion   : m4.mpu.t_subregion_range;
+      region      : m4.mpu.t_region_number;
+      found       : boolean;
    begin
-      for region in regions_pool'range loop
-         if regions_pool(region).addr = addr and
-            regions_pool(region).used
+
+      -- Coalesced device: only its subregion is disabled. The window is
+      -- looked up the same way it was when the device was mapped, as
+      -- windows of different sizes may overlap
+      if is_coalescable (size, region_type, subregion_mask) then
+
+         get_window (addr, size, window_addr, window_size, subregion);
+         find_window
+           (window_addr, window_size, region_type, region, found);
+
+         if found then
+            regions_pool(region).mask(subregion) :=
+               m4.mpu.SUB_REGION_DISABLED;
+
+            -- Last device of the window
+            if regions_pool(region).mask =
+               (m4.mpu.t_subregion_range => m4.mpu.SUB_REGION_DISABLED)
+            then
+               free_region (region);
+            else
+               ewok.mpu.update_subregions
+                 (region, regions_pool(region).mask);
+            end if;
+            return;
+         end if;
+
+      end if;
+
+      for r in regions_pool'range loop
+         if regions_pool(r).used            and
+            not regions_pool(r).coalescable and
+            regions_pool(r).addr = addr
          then
-            m4.mpu.disable_region (region);
-            regions_pool(region) := (used => false, addr => 0);
+            free_region (r);
             return;
          end if;
       end loop;
+
       raise program_error;
    end unmap_from_pool;
 
@@ -136,8 +320,7 @@ is
    is
    begin
       for region in regions_pool'range loop
-         m4.mpu.disable_region (region);
-         regions_pool(region) := (used => false, addr => 0);
+         free_region (region);
       end loop;
    end unmap_all_from_pool;
 
@@ -148,8 +331,9 @@ is
    is
    begin
       for region in regions_pool'range loop
-         if regions_pool(region).addr = addr and
-            regions_pool(region).used
+         if regions_pool(region).used and
+            addr >= regions_pool(region).addr and
+            addr -  regions_pool(region).addr < regions_pool(region).size
          then
             return true;
          end if;
@@ -29,6 +29,10 @@ with ewok.devices_shared;  use ewok.devices_shared;
 with ewok.sched;
 with soc.interrupts;
 with ewok.debug;
+#if CONFIG_KERNEL_TRACE_MPU
+with ewok.trace;
+with m4.scb;
+#end if;
 
 package body ewok.mpu.handler
    with spark_mode => off
@@ -42,6 +46,14 @@ is
       new_frame_a : t_stack_frame_access;
 #end if;
    begin
+#if CONFIG_KERNEL_TRACE_MPU
+      ewok.trace.event
+        (ewok.trace.TRACE_MPU_FAULT,
+         to_unsigned_32 (ewok.sched.current_task_id),
+         m4.scb.SCB.MMFAR.ADDRESS,
+         frame_a.all.PC);
+#end if;
+
       pragma DEBUG (ewok.tasks.debug.crashdump (frame_a));
       ewok.tasks.debug.crashdump (frame_a);
 
@@ -19,11 +19,11 @@
 --     limitations under the License.
 --
 --
-
 with ewok.exported.interrupts;   use ewok.exported.interrupts;
-with ewok.devices_shared;        use ewok.devices_shared;
 with ewok.interrupts;
-with ewok.devices;
+#if CONFIG_KERNEL_EXP_REENTRANCY
+with m4.cpu;
+#end if;
 
 package body ewok.posthook
    with spark_mode => off
@@ -42,6 +42,19 @@ is
    pragma inline (read_register);
 
 
+   procedure write_register
+     (addr  : in  system_address;
+      val   : in  unsigned_32)
+   is
+      reg : unsigned_32
+         with import, volatile_full_access, address => to_address (addr);
+   begin
+      reg := val;
+   end write_register;
+
+   pragma inline (write_register);
+
+
    procedure set_bits_in_register
      (addr  : in  system_address;
       bits  : in  unsigned_32;
@@ -57,36 +70,172 @@ is
       end if;
    end set_bits_in_register;
 
+   pragma inline (set_bits_in_register);
+
+
+   procedure compile
+     (config   : in  ewok.exported.interrupts.t_interrupt_config;
+      dev_addr : in  system_address;
+      id       : out t_posthook_id;
+      success  : out boolean)
+   is
+      posthook    : t_interrupt_posthook renames config.posthook;
+      program     : t_program;
+      op          : integer range 0 .. MAX_POSTHOOK_OPS := 0;
+      -- Offsets of the registers read, indexed by slot
+      read_offset : array (t_slot range 1 .. MAX_POSTHOOK_OPS) of unsigned_32
+                       := (others => 0);
+      last_slot   : t_slot := NO_SLOT;
+
+      -- Return the slot holding the first value read at that offset,
+      -- NO_SLOT if the register was not previously read
+      function get_slot (offset : unsigned_32) return t_slot
+      is
+      begin
+         for slot in 1 .. last_slot loop
+            if read_offset(slot) = offset then
+               return slot;
+            end if;
+         end loop;
+         return NO_SLOT;
+      end get_slot;
+
+   begin
+
+      id := ID_POSTHOOK_UNUSED;
+
+      for i in posthook.action'range loop
+         exit when posthook.action(i).instr = POSTHOOK_NIL;
+
+         op := op + 1;
+
+         case posthook.action(i).instr is
+
+            when POSTHOOK_NIL    => null;
+
+            when POSTHOOK_READ   =>
+               last_slot := last_slot + 1;
+               read_offset(last_slot) := posthook.action(i).read.offset;
+
+               program.ops(op) :=
+                 (opcode   => OP_READ,
+                  slot     => last_slot,
+                  dest     => dev_addr + posthook.action(i).read.offset,
+                  others   => <>);
+
+               -- Is that value to be returned to the ISR?
+               if posthook.status = posthook.action(i).read.offset then
+                  program.status_slot := last_slot;
+               end if;
+
+               if posthook.data = posthook.action(i).read.offset then
+                  program.data_slot := last_slot;
+               end if;
+
+            when POSTHOOK_WRITE  =>
+               if posthook.action(i).write.mask = 16#FFFF_FFFF# then
+                  program.ops(op) :=
+                    (opcode   => OP_WRITE_FULL,
+                     dest     => dev_addr + posthook.action(i).write.offset,
+                     src      => posthook.action(i).write.value,
+                     mask     => 16#FFFF_FFFF#,
+                     others   => <>);
+               else
+                  program.ops(op) :=
+                    (opcode   => OP_WRITE,
+                     dest     => dev_addr + posthook.action(i).write.offset,
+                     src      => posthook.action(i).write.value and
+                                 posthook.action(i).write.mask,
+                     mask     => posthook.action(i).write.mask,
+                     others   => <>);
+               end if;
+
+            when POSTHOOK_WRITE_REG =>
+               program.ops(op) :=
+                 (opcode   => OP_WRITE_REG,
+                  src_slot => get_slot (posthook.action(i).write_reg.offset_src),
+                  invert   => posthook.action(i).write_reg.mode = MODE_NOT,
+                  dest     => dev_addr + posthook.action(i).write_reg.offset_dest,
+                  src      => dev_addr + posthook.action(i).write_reg.offset_src,
+                  mask     => posthook.action(i).write_reg.mask,
+                  others   => <>);
+
+            when POSTHOOK_WRITE_MASK =>
+               program.ops(op) :=
+                 (opcode    => OP_WRITE_MASK,
+                  src_slot  => get_slot (posthook.action(i).write_mask.offset_src),
+                  mask_slot => get_slot (posthook.action(i).write_mask.offset_mask),
+                  invert    => posthook.action(i).write_mask.mode = MODE_NOT,
+                  dest      => dev_addr + posthook.action(i).write_mask.offset_dest,
+                  src       => dev_addr + posthook.action(i).write_mask.offset_src,
+                  mask      => dev_addr + posthook.action(i).write_mask.offset_mask,
+                  others    => <>);
+         end case;
+      end loop;
+
+      -- No posthook
+      if op = 0 then
+         success := true;
+         return;
+      end if;
+
+      for i in programs'range loop
+         if not programs(i).used then
+            programs(i).used    := true;
+            programs(i).program := program;
+            id      := i;
+            success := true;
+            return;
+         end if;
+      end loop;
+
+      success := false;
+
+   end compile;
+
+
+   procedure release
+     (id       : in  t_posthook_id)
+   is
+   begin
+      if id /= ID_POSTHOOK_UNUSED then
+         programs(id).used    := false;
+         programs(id).program := (others => <>);
+      end if;
+   end release;
+
+
+   function get_program
+     (id       : in  t_posthook_id)
+      return t_program_access
+   is
+   begin
+      if id = ID_POSTHOOK_UNUSED then
+         return NULL;
+      end if;
+      return programs(id).program'access;
+   end get_program;
+
 
    procedure exec
      (intr     : in  soc.interrupts.t_interrupt;
       status   : out unsigned_32;
       data     : out unsigned_32)
    is
-      dev_id   : ewok.devices_shared.t_device_id;
-      dev_addr : system_address;
-      config   : ewok.exported.interrupts.t_interrupt_config_access;
-      found    : boolean;
+      program_a: t_program_access;
+      slots    : array (t_slot range 1 .. MAX_POSTHOOK_OPS) of unsigned_32;
       val      : unsigned_32;
       mask     : unsigned_32;
    begin
 
-      config := ewok.devices.get_interrupt_config_from_interrupt (intr);
-      if config = NULL then
+      program_a :=
+         t_program_access (ewok.interrupts.interrupt_table(intr).posthook);
+      if program_a = NULL then
          status := 0;
          data   := 0;
          return;
       end if;
 
-      dev_id := ewok.interrupts.get_device_from_interrupt (intr);
-      if dev_id = ID_DEV_UNUSED then
-         status := 0;
-         data   := 0;
-         return;
-      end if;
-
-      dev_addr := ewok.devices.get_device_addr (dev_id);
-
 #if CONFIG_KERNEL_EXP_REENTRANCY
       -- posthooks are, by now, executed with ISR disabled, to avoid temporal holes
       -- when reading/writing data in device's registers and generating potential
@@ -94,133 +243,85 @@ is
       m4.cpu.disable_irq;
 #end if;
 
-      for i in config.all.posthook.action'range loop
-         case config.all.posthook.action(i).instr is
+      declare
+         program : t_program renames program_a.all;
+      begin
 
-            when POSTHOOK_NIL    =>
-#if CONFIG_KERNEL_EXP_REENTRANCY
-               -- No subsequent action. Returning.
-               m4.cpu.enable_irq;
-#end if;
-               return;
+         for i in program.ops'range loop
+            declare
+               op : t_operation renames program.ops(i);
+            begin
+               case op.opcode is
 
-            when POSTHOOK_READ   =>
-               val := read_register (dev_addr +
-                  system_address (config.all.posthook.action(i).read.offset));
+                  when OP_END       =>
+                     exit;
 
-               config.all.posthook.action(i).read.value := val;
+                  when OP_READ      =>
+                     slots(op.slot) := read_register (op.dest);
 
-               -- This value need to be saved ?
-               if config.all.posthook.status =
-                     config.all.posthook.action(i).read.offset
-               then
-                  status := val;
-               end if;
+                  when OP_WRITE     =>
+                     write_register
+                       (op.dest, (read_register (op.dest) and not op.mask) or op.src);
 
-               -- This value need to be saved ?
-               if
-                  config.all.posthook.data =
-                     config.all.posthook.action(i).read.offset
-               then
-                  data := val;
-               end if;
+                  when OP_WRITE_FULL   =>
+                     write_register (op.dest, op.src);
 
-            when POSTHOOK_WRITE  =>
-               set_bits_in_register
-                 (dev_addr + system_address
-                    (config.all.posthook.action(i).write.offset),
-                  config.all.posthook.action(i).write.mask,
-                  config.all.posthook.action(i).write.value);
-
-            when POSTHOOK_WRITE_REG    =>
-               -- Retrieving the already read register value
-               found := false;
-               for j in config.all.posthook.action'first .. i loop
-                  if config.all.posthook.action(j).instr = POSTHOOK_READ and then
-                     config.all.posthook.action(j).read.offset =
-                        config.all.posthook.action(i).write_reg.offset_src
-                  then
-                     val   := config.all.posthook.action(j).read.value;
-                     found := true;
-                     exit;
-                  end if;
-               end loop;
+                  when OP_WRITE_REG    =>
+                     if op.src_slot /= NO_SLOT then
+                        val := slots(op.src_slot);
+                     else
+                        val := read_register (op.src);
+                     end if;
 
-               if not found then
-                  val := read_register (dev_addr + system_address
-                     (config.all.posthook.action(i).write_reg.offset_src));
-               end if;
+                     -- Only active bits are written
+                     mask := op.mask and val;
 
-               -- Calculating the mask to apply in order to write only active
-               -- bits
-               mask := config.all.posthook.action(i).write_reg.mask and val;
+                     if op.invert then
+                        val := not val;
+                     end if;
 
-               -- Inverted write might be needed
-               if config.all.posthook.action(i).write_reg.mode = MODE_NOT then
-                  val := not val;
-               end if;
+                     set_bits_in_register (op.dest, mask, val);
 
-               -- Writing into the destination register
-               set_bits_in_register
-                 (dev_addr + system_address
-                    (config.all.posthook.action(i).write_reg.offset_dest),
-                  mask,
-                  val);
-
-            when POSTHOOK_WRITE_MASK   =>
-               -- Retrieving the value
-               found := false;
-               for j in config.all.posthook.action'first .. i loop
-                  if config.all.posthook.action(j).instr = POSTHOOK_READ and then
-                     config.all.posthook.action(j).read.offset =
-                        config.all.posthook.action(i).write_mask.offset_src
-                  then
-                     val   := config.all.posthook.action(j).read.value;
-                     found := true;
-                     exit;
-                  end if;
-               end loop;
+                  when OP_WRITE_MASK   =>
+                     if op.src_slot /= NO_SLOT then
+                        val := slots(op.src_slot);
+                     else
+                        val := read_register (op.src);
+                     end if;
 
-               if not found then
-                  val := read_register (dev_addr + system_address
-                     (config.all.posthook.action(i).write_mask.offset_src));
-               end if;
+                     if op.mask_slot /= NO_SLOT then
+                        mask := slots(op.mask_slot);
+                     else
+                        mask := read_register (op.mask);
+                     end if;
 
-               -- Retrieving the mask
-               found := false;
-               for j in config.all.posthook.action'first .. i loop
-                  if config.all.posthook.action(j).instr = POSTHOOK_READ and then
-                     config.all.posthook.action(j).read.offset =
-                        config.all.posthook.action(i).write_mask.offset_mask
-                  then
-                     mask  := config.all.posthook.action(j).read.value;
-                     found := true;
-                     exit;
-                  end if;
-               end loop;
+                     -- Only active bits are written
+                     mask := mask and val;
 
-               if not found then
-                  mask := read_register (dev_addr + system_address
-                     (config.all.posthook.action(i).write_mask.offset_mask));
-               end if;
+                     if op.invert then
+                        val := not val;
+                     end if;
 
-               -- Calculating the mask
-               mask := mask and val;
+                     set_bits_in_register (op.dest, mask, val);
 
-               -- Inverted write might be needed
-               if config.all.posthook.action(i).write_mask.mode = MODE_NOT then
-                  val := not val;
-               end if;
+               end case;
+            end;
+         end loop;
 
-               -- Writing into the destination register
-               set_bits_in_register
-                 (dev_addr + system_address
-                    (config.all.posthook.action(i).write_mask.offset_dest),
-                  mask,
-                  val);
+         -- Values returned to the user ISR
+         if program.status_slot /= NO_SLOT then
+            status := slots(program.status_slot);
+         else
+            status := 0;
+         end if;
 
-         end case;
-      end loop;
+         if program.data_slot /= NO_SLOT then
+            data := slots(program.data_slot);
+         else
+            data := 0;
+         end if;
+
+      end;
 
 #if CONFIG_KERNEL_EXP_REENTRANCY
       -- Let's enable again IRQs
@@ -20,13 +20,142 @@
 --
 --
 
+
 with ewok.debug;
 with soc.rng;
+#if CONFIG_KERNEL_RNG_POOL
+with m4.cpu;
+with ewok.interrupts;
+with ewok.tasks_shared;
+with ewok.devices_shared;
+with soc.interrupts;
+with soc.nvic;
+#end if;
 
 package body ewok.rng
    with spark_mode => off
 is
 
+#if CONFIG_KERNEL_RNG_POOL
+   --
+   -- Entropy pool, refilled by the RNG data ready interrupt. The interrupt
+   -- is disabled when the pool is full and enabled again each time some
+   -- words are drawn. Words that fail the health checks (repetition or
+   -- seed error) are discarded.
+   --
+
+   POOL_SIZE   : constant := $CONFIG_KERNEL_RNG_POOL_SIZE;
+
+   subtype t_pool_index is natural range 0 .. POOL_SIZE - 1;
+
+   pool        : array (t_pool_index) of unsigned_32;
+   pool_head   : t_pool_index := 0;
+   pool_tail   : t_pool_index := 0;
+   pool_count  : natural range 0 .. POOL_SIZE := 0;
+
+
+   procedure rng_handler
+     (frame_a : in ewok.t_stack_frame_access)
+   is
+      pragma unreferenced (frame_a);
+      primask  : constant unsigned_32 := m4.cpu.get_primask_register;
+      rand     : unsigned_32;
+      ok       : boolean;
+   begin
+      m4.cpu.disable_irq;
+
+      if not soc.rng.is_ready then
+         -- Seed or clock error. The interrupt is enabled again on next
+         -- draw, preventing an interrupt storm on a faulty source.
+         soc.rng.clear_errors;
+         soc.rng.set_interrupt (false);
+         m4.cpu.set_primask_register (primask);
+         return;
+      end if;
+
+      soc.rng.read (rand, ok);
+
+      if not ok then
+         soc.rng.set_interrupt (false);
+      elsif pool_count < POOL_SIZE then
+         pool(pool_head)   := rand;
+         pool_head         := (pool_head + 1) mod POOL_SIZE;
+         pool_count        := pool_count + 1;
+      end if;
+
+      if pool_count = POOL_SIZE then
+         soc.rng.set_interrupt (false);
+      end if;
+
+      m4.cpu.set_primask_register (primask);
+   end rng_handler;
+
+
+   -- Draw a word from the pool. If the pool is empty, the RNG is polled.
+   procedure draw
+     (rand     : out unsigned_32;
+      success  : out boolean)
+   is
+      primask  : constant unsigned_32 := m4.cpu.get_primask_register;
+   begin
+      m4.cpu.disable_irq;
+
+      if pool_count > 0 then
+         rand              := pool(pool_tail);
+         pool(pool_tail)   := 0;
+         pool_tail         := (pool_tail + 1) mod POOL_SIZE;
+         pool_count        := pool_count - 1;
+         success           := true;
+      else
+         soc.rng.random (rand, success);
+      end if;
+
+      soc.rng.set_interrupt (true);
+
+      m4.cpu.set_primask_register (primask);
+   end draw;
+
+
+   procedure init
+   is
+      ok : boolean;
+   begin
+
+      ewok.interrupts.set_interrupt_handler
+        (soc.interrupts.INT_HASH_RNG,
+         rng_handler'access,
+         ewok.tasks_shared.ID_KERNEL,
+         ewok.devices_shared.ID_DEV_UNUSED,
+         ok);
+
+      if not ok then raise program_error; end if;
+
+      soc.nvic.enable_irq
+        (soc.nvic.to_irq_number (soc.interrupts.INT_HASH_RNG));
+
+      soc.rng.set_interrupt (true);
+
+   end init;
+
+#else
+
+   procedure draw
+     (rand     : out unsigned_32;
+      success  : out boolean)
+   is
+   begin
+      soc.rng.random (rand, success);
+   end draw;
+
+
+   procedure init
+   is
+   begin
+      null;
+   end init;
+
+#end if;
+
 
    procedure random_array
      (tab      : out unsigned_8_array;
@@ -43,9 +172,9 @@ is
    begin
 
       index := tab'first;
-      while index < tab'last loop
+      while index <= tab'last loop
 
-         soc.rng.random (rand, ok);
+         draw (rand, ok);
          if not ok then
             pragma DEBUG (debug.log (debug.ERROR, "RNG failed!"));
             success := false;
@@ -72,7 +201,7 @@ is
       success  : out boolean)
    is
    begin
-      soc.rng.random (rand, success);
+      draw (rand, success);
       if not success then
          pragma DEBUG (debug.log (debug.ERROR, "RNG failed!"));
       end if;
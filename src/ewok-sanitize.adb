@@ -21,7 +21,9 @@
 --
 
 
+#if not CONFIG_KERNEL_ISR_PER_TASK_STACK
 with ewok.layout; use ewok.layout;
+#end if;
 with ewok.tasks;  use ewok.tasks;
 with ewok.devices_shared; use ewok.devices_shared;
 with ewok.devices;
@@ -38,6 +40,9 @@ is
       return boolean
    is
       user_task : ewok.tasks.t_task renames ewok.tasks.tasks_list(task_id);
+#if CONFIG_KERNEL_ISR_PER_TASK_STACK
+      pragma unreferenced (mode);
+#end if;
    begin
 
       if ptr >= user_task.data_start   and
@@ -46,6 +51,7 @@ is
          return true;
       end if;
 
+#if not CONFIG_KERNEL_ISR_PER_TASK_STACK
       -- ISR mode is a special case because the stack is therefore
       -- mutualized (thus only one ISR can be executed at the same time)
       if mode = TASK_MODE_ISRTHREAD    and
@@ -54,6 +60,7 @@ is
       then
          return true;
       end if;
+#end if;
 
       return false;
    end is_word_in_data_region;
@@ -156,6 +163,9 @@ is
       return boolean
    is
       user_task : ewok.tasks.t_task renames ewok.tasks.tasks_list(task_id);
+#if CONFIG_KERNEL_ISR_PER_TASK_STACK
+      pragma unreferenced (mode);
+#end if;
    begin
 
       if ptr >= user_task.data_start       and
@@ -165,6 +175,7 @@ is
          return true;
       end if;
 
+#if not CONFIG_KERNEL_ISR_PER_TASK_STACK
       if mode = TASK_MODE_ISRTHREAD    and
          ptr >= STACK_BOTTOM_TASK_ISR  and
          ptr + size >= ptr             and
@@ -172,6 +183,7 @@ is
       then
          return true;
       end if;
+#end if;
 
       return false;
    end is_range_in_data_region;
@@ -27,13 +27,27 @@ with ewok.tasks;           use ewok.tasks;
 with ewok.devices_shared;  use ewok.devices_shared;
 with ewok.sleep;
 with ewok.alarm;
+#if CONFIG_KERNEL_ISR_PER_TASK_STACK
+with ewok.softirq;
+#end if;
 with ewok.syscalls.handler;
 with ewok.memory;
 with ewok.interrupts;
 with soc.interrupts;
 with soc.dwt;
+#if CONFIG_KERNEL_ISR_LATENCY_STATS
+with ewok.cycles;
+with ewok.latency;
+with ewok.exported.latency;
+#end if;
 with m4.scb;
 with m4.systick;
+#if CONFIG_KERNEL_TRACE_SCHED
+with ewok.trace;
+#end if;
+#if CONFIG_KERNEL_BENCH
+with ewok.bench;
+#end if;
 
 
 package body ewok.sched
@@ -70,12 +84,53 @@ is
       elected  : t_task_id;
    begin
 
+#if CONFIG_KERNEL_ISR_PER_TASK_STACK
+      --
+      -- Each task owning its ISR stack, the SOFTIRQ can start new ISR
+      -- threads while others are still running
+      --
+
+      if ewok.tasks.get_state
+              (ID_SOFTIRQ, TASK_MODE_MAINTHREAD) = TASK_STATE_RUNNABLE then
+         elected := ID_SOFTIRQ;
+         goto ok_return;
+      end if;
+
+      --
+      -- Execute pending user ISRs first, higher priority tasks first
+      --
+
+      declare
+         max_prio : unsigned_8 := 0;
+         found    : boolean    := false;
+      begin
+         elected := ID_UNUSED;
+         for id in config.applications.list'range loop
+            if TSK.tasks_mode(id) = TASK_MODE_ISRTHREAD
+               and then
+               ewok.tasks.get_state (id, TASK_MODE_ISRTHREAD) = TASK_STATE_RUNNABLE
+               and then
+               ewok.tasks.get_state (id, TASK_MODE_MAINTHREAD) /= TASK_STATE_LOCKED
+               and then
+               (not found or TSK.tasks_prio(id) > max_prio)
+            then
+               elected  := id;
+               max_prio := TSK.tasks_prio(id);
+               found    := true;
+            end if;
+         end loop;
+
+         if found then
+            goto ok_return;
+         end if;
+      end;
+#else
       --
       -- Execute pending user ISRs first
       --
 
       for id in config.applications.list'range loop
-         if TSK.tasks_list(id).mode = TASK_MODE_ISRTHREAD
+         if TSK.tasks_mode(id) = TASK_MODE_ISRTHREAD
             and then
             ewok.tasks.get_state (id, TASK_MODE_ISRTHREAD) = TASK_STATE_RUNNABLE
             and then
@@ -85,15 +140,16 @@ is
             goto ok_return;
          end if;
       end loop;
+#end if;
 
       --
       -- Execute tasks in critical sections
       --
 
       for id in config.applications.list'range loop
-         if TSK.tasks_list(id).state = TASK_STATE_LOCKED then
+         if TSK.tasks_state(id) = TASK_STATE_LOCKED then
             elected := id;
-            if TSK.tasks_list(id).mode = TASK_MODE_MAINTHREAD then
+            if TSK.tasks_mode(id) = TASK_MODE_MAINTHREAD then
                last_main_user_task_id := elected;
             end if;
             goto ok_return;
@@ -106,7 +162,7 @@ is
 
       for id in config.applications.list'range loop
 
-         if TSK.tasks_list(id).mode = TASK_MODE_ISRTHREAD
+         if TSK.tasks_mode(id) = TASK_MODE_ISRTHREAD
             and then
             ewok.tasks.get_state (id, TASK_MODE_ISRTHREAD) = TASK_STATE_ISR_DONE
          then
@@ -122,11 +178,20 @@ is
             -- become runnable
             if ewok.sleep.is_sleeping (id) then
                ewok.sleep.try_waking_up (id);
-            elsif TSK.tasks_list(id).state = TASK_STATE_IDLE then
+            elsif TSK.tasks_state(id) = TASK_STATE_IDLE then
                ewok.tasks.set_state
                  (id, TASK_MODE_MAINTHREAD, TASK_STATE_RUNNABLE);
             end if;
 
+#if CONFIG_KERNEL_ISR_PER_TASK_STACK
+            -- Some requests for that task might have been postponed by
+            -- the SOFTIRQ
+            if ewok.softirq.has_pending_requests then
+               ewok.tasks.set_state
+                 (ID_SOFTIRQ, TASK_MODE_MAINTHREAD, TASK_STATE_RUNNABLE);
+            end if;
+#end if;
+
          end if;
 
       end loop;
@@ -146,7 +211,7 @@ is
       --
 
       for id in config.applications.list'range loop
-         if TSK.tasks_list(id).state = TASK_STATE_FORCED then
+         if TSK.tasks_state(id) = TASK_STATE_FORCED then
             ewok.tasks.set_state
               (id, TASK_MODE_MAINTHREAD, TASK_STATE_RUNNABLE);
             elected := id;
@@ -157,12 +222,12 @@ is
 
 #if CONFIG_SCHED_RAND
       declare
-         random   : aliased unsigned_32;
+         random   : unsigned_32;
          id       : t_task_id;
          ok       : boolean;
          pragma unreferenced (ok);
       begin
-         ewok.rng.random (random'access, ok);
+         ewok.rng.random (random, ok);
          id := t_task_id'val ((config.applications.list'first)'pos +
                             (random mod config.applications.list'length));
          for i in 1 .. config.applications.list'length loop
@@ -209,12 +274,12 @@ is
 
          -- Max priority
          for id in config.applications.list'range loop
-            if TSK.tasks_list(id).prio > max_prio
+            if TSK.tasks_prio(id) > max_prio
                and
                ewok.tasks.get_state (id, TASK_MODE_MAINTHREAD)
                   = TASK_STATE_RUNNABLE
             then
-               max_prio := TSK.tasks_list(id).prio;
+               max_prio := TSK.tasks_prio(id);
             end if;
          end loop;
 
@@ -226,7 +291,7 @@ is
             else
                id := config.applications.list'first;
             end if;
-            if TSK.tasks_list(id).prio = max_prio
+            if TSK.tasks_prio(id) = max_prio
                and
                ewok.tasks.get_state (id, TASK_MODE_MAINTHREAD)
                   = TASK_STATE_RUNNABLE
@@ -249,6 +314,28 @@ is
    end task_elect;
 
 
+#if CONFIG_KERNEL_ISR_LATENCY_STATS
+   -- Account the scheduling latency of an ISR thread on its first run
+   procedure isr_thread_elected
+   is
+      use type soc.interrupts.t_interrupt;
+      isr_ctx : t_isr_context renames TSK.tasks_list(current_task_id).isr_ctx;
+   begin
+      if current_task_mode = TASK_MODE_ISRTHREAD and
+         isr_ctx.lat_interrupt /= soc.interrupts.INT_NONE and
+         not isr_ctx.lat_started
+      then
+         ewok.latency.account
+           (isr_ctx.lat_interrupt,
+            ewok.exported.latency.LAT_SCHEDULED,
+            isr_ctx.lat_stamp);
+         isr_ctx.lat_stamp   := ewok.cycles.get_cycles;
+         isr_ctx.lat_started := true;
+      end if;
+   end isr_thread_elected;
+#end if;
+
+
    function pendsv_handler
      (frame_a : ewok.t_stack_frame_access)
       return ewok.t_stack_frame_access
@@ -261,6 +348,12 @@ is
       if current_task_mode = TASK_MODE_ISRTHREAD and then
          ewok.tasks.get_state
            (current_task_id, TASK_MODE_ISRTHREAD) = TASK_STATE_RUNNABLE
+#if CONFIG_KERNEL_ISR_PER_TASK_STACK
+         -- unless the SOFTIRQ has some new ISRs to start
+         and then
+         ewok.tasks.get_state
+           (ID_SOFTIRQ, TASK_MODE_MAINTHREAD) /= TASK_STATE_RUNNABLE
+#end if;
       then
          return frame_a;
       end if;
@@ -285,7 +378,13 @@ is
 
       -- Elect a new task and change current_task_id
       current_task_id   := task_elect;
-      current_task_mode := TSK.tasks_list(current_task_id).mode;
+      current_task_mode := TSK.tasks_mode(current_task_id);
+#if CONFIG_KERNEL_ISR_LATENCY_STATS
+      isr_thread_elected;
+#end if;
+#if CONFIG_KERNEL_BENCH
+      ewok.bench.task_elected (current_task_id, current_task_mode);
+#end if;
 
 #if CONFIG_KERNEL_EXP_REENTRANCY
       -- End of global variables WR access
@@ -297,6 +396,13 @@ is
            (current_task_id = old_task_id and
             current_task_mode = old_task_mode)
       then
+#if CONFIG_KERNEL_TRACE_SCHED
+         ewok.trace.event
+           (ewok.trace.TRACE_SCHED_SWITCH,
+            to_unsigned_32 (old_task_id),
+            to_unsigned_32 (current_task_id),
+            t_task_mode'pos (current_task_mode));
+#end if;
          ewok.memory.map_task (current_task_id);
       end if;
 
@@ -348,10 +454,24 @@ is
       -- Trigger alarms
       ewok.alarm.check_alarms;
 
+#if CONFIG_KERNEL_ISR_PER_TASK_STACK
+      -- Requests postponed by the SOFTIRQ (locked or sleeping tasks) are
+      -- reconsidered each scheduling period
+      if ewok.softirq.has_pending_requests then
+         ewok.tasks.set_state
+           (ID_SOFTIRQ, TASK_MODE_MAINTHREAD, TASK_STATE_RUNNABLE);
+      end if;
+#end if;
+
       -- Keep ISR threads running until they finish
       if current_task_mode = TASK_MODE_ISRTHREAD and then
          ewok.tasks.get_state
            (current_task_id, TASK_MODE_ISRTHREAD) = TASK_STATE_RUNNABLE
+#if CONFIG_KERNEL_ISR_PER_TASK_STACK
+         and then
+         ewok.tasks.get_state
+           (ID_SOFTIRQ, TASK_MODE_MAINTHREAD) /= TASK_STATE_RUNNABLE
+#end if;
       then
 #if CONFIG_KERNEL_EXP_REENTRANCY
          m4.cpu.enable_irq;
@@ -368,7 +488,13 @@ is
 
       -- Elect a new task
       current_task_id   := task_elect;
-      current_task_mode := TSK.tasks_list(current_task_id).mode;
+      current_task_mode := TSK.tasks_mode(current_task_id);
+#if CONFIG_KERNEL_ISR_LATENCY_STATS
+      isr_thread_elected;
+#end if;
+#if CONFIG_KERNEL_BENCH
+      ewok.bench.task_elected (current_task_id, current_task_mode);
+#end if;
 
 #if CONFIG_KERNEL_EXP_REENTRANCY
       -- End of global variable access
@@ -380,6 +506,13 @@ is
            (current_task_id = old_task_id and
             current_task_mode = old_task_mode)
       then
+#if CONFIG_KERNEL_TRACE_SCHED
+         ewok.trace.event
+           (ewok.trace.TRACE_SCHED_SWITCH,
+            to_unsigned_32 (old_task_id),
+            to_unsigned_32 (current_task_id),
+            t_task_mode'pos (current_task_mode));
+#end if;
          ewok.memory.map_task (current_task_id);
       end if;
 
@@ -428,6 +561,11 @@ is
 
       if not ok then raise program_error; end if;
 
+      -- The first user task is elected as soon as the idle task enables
+      -- the interrupts, without waiting for the first systick (MLQ-RR
+      -- scheduler elects the highest priority task)
+      request_schedule;
+
       --
       -- Jump to the kernel task
       --
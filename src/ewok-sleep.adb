@@ -22,6 +22,9 @@
 
 with ewok.tasks;        use ewok.tasks;
 with ewok.tasks_shared; use ewok.tasks_shared;
+#if CONFIG_KERNEL_BENCH
+with ewok.bench;
+#end if;
 
 package body ewok.sleep
    with spark_mode => off
@@ -53,11 +56,14 @@ is
       t : constant m4.systick.t_tick := m4.systick.get_ticks;
    begin
       for id in config.applications.list'range loop
-         if (TSK.tasks_list(id).state = TASK_STATE_SLEEPING or
-            TSK.tasks_list(id).state = TASK_STATE_SLEEPING_DEEP) and then
+         if (TSK.tasks_state(id) = TASK_STATE_SLEEPING or
+            TSK.tasks_state(id) = TASK_STATE_SLEEPING_DEEP) and then
             t > awakening_time(id)
          then
             TSK.set_state (id, TASK_MODE_MAINTHREAD, TASK_STATE_RUNNABLE);
+#if CONFIG_KERNEL_BENCH
+            ewok.bench.start_wakeup (id, ewok.bench.BENCH_SLEEP_WAKEUP);
+#end if;
          end if;
       end loop;
    end check_is_awoke;
@@ -67,7 +73,7 @@ is
      (task_id : in  t_real_task_id)
    is
    begin
-      if TSK.tasks_list(task_id).state = TASK_STATE_SLEEPING or else
+      if TSK.tasks_state(task_id) = TASK_STATE_SLEEPING or else
          awakening_time(task_id) < m4.systick.get_ticks
       then
          TSK.set_state (task_id, TASK_MODE_MAINTHREAD, TASK_STATE_RUNNABLE);
@@ -80,8 +86,8 @@ is
       return boolean
    is
    begin
-      if TSK.tasks_list(task_id).state = TASK_STATE_SLEEPING or
-         TSK.tasks_list(task_id).state = TASK_STATE_SLEEPING_DEEP
+      if TSK.tasks_state(task_id) = TASK_STATE_SLEEPING or
+         TSK.tasks_state(task_id) = TASK_STATE_SLEEPING_DEEP
       then
          if awakening_time(task_id) > m4.systick.get_ticks then
             return true;
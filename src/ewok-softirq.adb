@@ -27,12 +27,27 @@ with ewok.debug;
 with ewok.devices;
 with ewok.exported.interrupts;
    use type ewok.exported.interrupts.t_interrupt_config_access;
+#if CONFIG_KERNEL_ISR_COALESCING
+   use type ewok.exported.interrupts.t_isr_coalescing;
+#end if;
 with ewok.interrupts;
+#if not CONFIG_KERNEL_ISR_PER_TASK_STACK
 with ewok.layout;
+#if CONFIG_KERNEL_STACK_WATERMARK
+with ewok.watermark;
+#else
+with ewok.memops;
+#end if;
+#end if;
 with ewok.sched;
 with soc.interrupts; use type soc.interrupts.t_interrupt;
 with soc.nvic;
 with m4.cpu;
+#if CONFIG_KERNEL_ISR_LATENCY_STATS
+with ewok.cycles;
+with ewok.latency;
+with ewok.exported.latency;
+#end if;
 
 #if CONFIG_DBGLEVEL >= 7
 with types.c; use types.c;
@@ -79,6 +94,62 @@ is
    end push_isr;
 
 
+#if CONFIG_KERNEL_ISR_COALESCING
+   function is_same_isr
+     (item     : t_isr_request;
+      new_item : t_isr_request)
+      return boolean
+   is
+   begin
+      return
+         item.caller_id          = new_item.caller_id          and
+         item.params.interrupt   = new_item.params.interrupt   and
+         item.params.handler     = new_item.params.handler;
+   end is_same_isr;
+
+
+   procedure coalesce_isr
+     (item     : in out t_isr_request;
+      new_item : in     t_isr_request)
+   is
+   begin
+      item.params.posthook_status :=
+         item.params.posthook_status or new_item.params.posthook_status;
+      item.params.posthook_data   := new_item.params.posthook_data;
+      if item.params.count < unsigned_16'last then
+         item.params.count := item.params.count + 1;
+      end if;
+   end coalesce_isr;
+
+
+   procedure merge_isr_request is
+      new p_isr_requests.merge_item (is_same_isr, coalesce_isr);
+
+
+   procedure push_isr_coalesced
+     (task_id     : in  ewok.tasks_shared.t_task_id;
+      params      : in  t_isr_parameters)
+   is
+      req   : constant t_isr_request := (task_id, params);
+      ok    : boolean;
+   begin
+#if CONFIG_KERNEL_EXP_REENTRANCY
+      -- accessing the softirq input queue is not reentrant
+      m4.cpu.disable_irq;
+#end if;
+      merge_isr_request (isr_queue, req, ok);
+#if CONFIG_KERNEL_EXP_REENTRANCY
+      m4.cpu.enable_irq;
+#end if;
+
+      -- No pending request for that interrupt
+      if not ok then
+         push_isr (task_id, params);
+      end if;
+   end push_isr_coalesced;
+#end if;
+
+
    procedure push_soft
      (task_id     : in  ewok.tasks_shared.t_task_id;
       params      : in  t_soft_parameters)
@@ -105,6 +176,74 @@ is
    end push_soft;
 
 
+   function is_same_soft
+     (item     : t_soft_request;
+      new_item : t_soft_request)
+      return boolean
+   is
+   begin
+      return
+         item.caller_id       = new_item.caller_id       and
+         item.params.handler  = new_item.params.handler;
+   end is_same_soft;
+
+
+   procedure coalesce_soft
+     (item     : in out t_soft_request;
+      new_item : in     t_soft_request)
+   is
+   begin
+      item.params := new_item.params;
+   end coalesce_soft;
+
+
+   procedure merge_soft_request is
+      new p_soft_requests.merge_item (is_same_soft, coalesce_soft);
+
+
+   procedure push_soft_coalesced
+     (task_id     : in  ewok.tasks_shared.t_task_id;
+      params      : in  t_soft_parameters;
+      success     : out boolean)
+   is
+      req   : constant t_soft_request := (task_id, params);
+   begin
+#if CONFIG_KERNEL_EXP_REENTRANCY
+      -- accessing the softirq input queue is not reentrant
+      m4.cpu.disable_irq;
+#end if;
+      merge_soft_request (soft_queue, req, success);
+      if not success then
+         p_soft_requests.write (soft_queue, req, success);
+      end if;
+#if CONFIG_KERNEL_EXP_REENTRANCY
+      m4.cpu.enable_irq;
+#end if;
+      if success then
+         ewok.tasks.set_state
+           (ID_SOFTIRQ, TASK_MODE_MAINTHREAD, TASK_STATE_RUNNABLE);
+      end if;
+   end push_soft_coalesced;
+
+
+   function isr_stack_top
+     (task_id : ewok.tasks_shared.t_task_id)
+      return system_address
+   is
+#if not CONFIG_KERNEL_ISR_PER_TASK_STACK
+      pragma unreferenced (task_id);
+#end if;
+   begin
+#if CONFIG_KERNEL_ISR_PER_TASK_STACK
+      -- Each task owns its ISR stack. No need to wipe it as no other
+      -- task can access it
+      return TSK.tasks_list(task_id).isr_ctx.stack_top;
+#else
+      return ewok.layout.STACK_TOP_TASK_ISR;
+#end if;
+   end isr_stack_top;
+
+
    procedure isr_handler (req : in  t_isr_request)
    is
       params   : t_parameters;
@@ -136,18 +275,21 @@ is
          TSK.tasks_list(req.caller_id).isr_ctx.sched_policy := ISR_STANDARD;
       end if;
 
+#if not CONFIG_KERNEL_ISR_PER_TASK_STACK
       -- Zeroing the ISR stack if the ISR previously executed belongs to
       -- another task
       if previous_isr_owner /= req.caller_id then
-         declare
-            stack : byte_array(1 .. ewok.layout.STACK_SIZE_TASK_ISR)
-               with address => to_address (ewok.layout.STACK_BOTTOM_TASK_ISR);
-         begin
-            stack := (others => 0);
-         end;
+#if CONFIG_KERNEL_STACK_WATERMARK
+         ewok.watermark.repaint_isr_stack;
+#else
+         ewok.memops.fill
+           (ewok.layout.STACK_BOTTOM_TASK_ISR, 0,
+            ewok.layout.STACK_SIZE_TASK_ISR);
+#end if;
 
          previous_isr_owner := req.caller_id;
       end if;
+#end if;
 
       --
       -- Note - isr_ctx.entry_point is a wrapper. The real ISR entry
@@ -161,17 +303,42 @@ is
       params(2) := unsigned_32'val
         (soc.nvic.to_irq_number (req.params.interrupt));
 
+#if CONFIG_KERNEL_ISR_COALESCING
+      -- Number of coalesced interrupts is passed in the upper 16 bits
+      if config_a /= NULL and then
+         config_a.all.coalescing = ewok.exported.interrupts.ISR_COALESCING
+      then
+         params(2) := params(2) or
+            shift_left (unsigned_32 (req.params.count), 16);
+      end if;
+#end if;
+
       -- Status and data returned by the 'posthook' treatement
       -- (cf. ewok.posthook.exec)
       params(3) := req.params.posthook_status;
       params(4) := req.params.posthook_data;
 
       create_stack
-        (ewok.layout.STACK_TOP_TASK_ISR,
+        (isr_stack_top (req.caller_id),
          TSK.tasks_list(req.caller_id).isr_ctx.entry_point, -- Wrapper
          params,
          TSK.tasks_list(req.caller_id).isr_ctx.frame_a);
 
+#if CONFIG_KERNEL_ISR_LATENCY_STATS
+      ewok.latency.account
+        (req.params.interrupt,
+         ewok.exported.latency.LAT_QUEUED,
+         req.params.posthook_stamp);
+
+      TSK.tasks_list(req.caller_id).isr_ctx.lat_interrupt :=
+         req.params.interrupt;
+      TSK.tasks_list(req.caller_id).isr_ctx.lat_entry   :=
+         req.params.entry_stamp;
+      TSK.tasks_list(req.caller_id).isr_ctx.lat_stamp   :=
+         ewok.cycles.get_cycles;
+      TSK.tasks_list(req.caller_id).isr_ctx.lat_started := false;
+#end if;
+
       ewok.tasks.set_mode (req.caller_id, TASK_MODE_ISRTHREAD);
       ewok.tasks.set_state
         (req.caller_id, TASK_MODE_ISRTHREAD, TASK_STATE_RUNNABLE);
@@ -186,19 +353,26 @@ is
 
       TSK.tasks_list(req.caller_id).isr_ctx.device_id    := ID_DEV_UNUSED;
       TSK.tasks_list(req.caller_id).isr_ctx.sched_policy := ISR_STANDARD;
+#if CONFIG_KERNEL_ISR_LATENCY_STATS
+      TSK.tasks_list(req.caller_id).isr_ctx.lat_interrupt :=
+         soc.interrupts.INT_NONE;
+#end if;
 
+#if not CONFIG_KERNEL_ISR_PER_TASK_STACK
       -- Zeroing the ISR stack if the ISR previously executed belongs to
       -- another task
       if previous_isr_owner /= req.caller_id then
-         declare
-            stack : byte_array(1 .. ewok.layout.STACK_SIZE_TASK_ISR)
-               with address => to_address (ewok.layout.STACK_BOTTOM_TASK_ISR);
-         begin
-            stack := (others => 0);
-         end;
+#if CONFIG_KERNEL_STACK_WATERMARK
+         ewok.watermark.repaint_isr_stack;
+#else
+         ewok.memops.fill
+           (ewok.layout.STACK_BOTTOM_TASK_ISR, 0,
+            ewok.layout.STACK_SIZE_TASK_ISR);
+#end if;
 
          previous_isr_owner := req.caller_id;
       end if;
+#end if;
 
       -- User defined ISR handler
       params(1) := req.params.handler;
@@ -213,7 +387,7 @@ is
       -- point is defined in params(1)
       --
       create_stack
-        (ewok.layout.STACK_TOP_TASK_ISR,
+        (isr_stack_top (req.caller_id),
          TSK.tasks_list(req.caller_id).isr_ctx.entry_point, -- Wrapper
          params,
          TSK.tasks_list(req.caller_id).isr_ctx.frame_a);
@@ -225,6 +399,88 @@ is
    end soft_handler;
 
 
+   function has_pending_requests return boolean
+   is
+   begin
+      return
+         p_isr_requests.state (isr_queue)   /= p_isr_requests.EMPTY or
+         p_soft_requests.state (soft_queue) /= p_soft_requests.EMPTY;
+   end has_pending_requests;
+
+
+#if CONFIG_KERNEL_ISR_PER_TASK_STACK
+   -- A task has only one ISR context. Its next ISR can't be started
+   -- before the previous one is done.
+   function is_dispatchable
+     (task_id : ewok.tasks_shared.t_task_id)
+      return boolean
+   is
+   begin
+      return
+         TSK.tasks_state(task_id)   /= TASK_STATE_LOCKED          and
+         TSK.tasks_state(task_id)   /= TASK_STATE_SLEEPING_DEEP   and
+         TSK.tasks_mode(task_id)    /= TASK_MODE_ISRTHREAD;
+   end is_dispatchable;
+
+
+   procedure main_task
+   is
+      isr_req  : t_isr_request;
+      soft_req : t_soft_request;
+      ok       : boolean;
+   begin
+
+      loop
+
+         m4.cpu.disable_irq;
+
+         -- Each task owning its ISR stack, every pending request can be
+         -- dispatched at once. The resulting ISR threads are then elected
+         -- by the scheduler in task priority order.
+         -- Requests that can't be handled yet are kept in the queue. Queues
+         -- are walked at most once, thus the softirq never spins on them
+         -- (cf. ewok.sched for the wake up)
+
+         for i in 1 .. MAX_QUEUE_SIZE loop
+            p_isr_requests.read (isr_queue, isr_req, ok);
+            exit when not ok;
+
+            if is_dispatchable (isr_req.caller_id) then
+               isr_handler (isr_req);
+            else
+               p_isr_requests.write (isr_queue, isr_req, ok);
+               if not ok then
+                  debug.panic ("SOFTIRQ failed to add ISR request");
+               end if;
+            end if;
+         end loop;
+
+         for i in 1 .. MAX_QUEUE_SIZE loop
+            p_soft_requests.read (soft_queue, soft_req, ok);
+            exit when not ok;
+
+            if is_dispatchable (soft_req.caller_id) then
+               soft_handler (soft_req);
+            else
+               p_soft_requests.write (soft_queue, soft_req, ok);
+               if not ok then
+                  debug.panic ("SOFTIRQ failed to add ISR request");
+               end if;
+            end if;
+         end loop;
+
+         ewok.tasks.set_state
+           (ID_SOFTIRQ, TASK_MODE_MAINTHREAD, TASK_STATE_IDLE);
+         ewok.sched.request_schedule;
+
+         m4.cpu.enable_irq;
+
+      end loop;
+
+   end main_task;
+
+#else
+
    procedure main_task
    is
       isr_req  : t_isr_request;
@@ -243,8 +499,8 @@ is
                exit;
             end if;
 
-            if TSK.tasks_list(isr_req.caller_id).state /= TASK_STATE_LOCKED and
-               TSK.tasks_list(isr_req.caller_id).state /= TASK_STATE_SLEEPING_DEEP
+            if TSK.tasks_state(isr_req.caller_id) /= TASK_STATE_LOCKED and
+               TSK.tasks_state(isr_req.caller_id) /= TASK_STATE_SLEEPING_DEEP
             then
                isr_handler (isr_req);
                ewok.sched.request_schedule;
@@ -268,8 +524,8 @@ is
                exit;
             end if;
 
-            if TSK.tasks_list(soft_req.caller_id).state /= TASK_STATE_LOCKED and
-               TSK.tasks_list(soft_req.caller_id).state /= TASK_STATE_SLEEPING_DEEP
+            if TSK.tasks_state(soft_req.caller_id) /= TASK_STATE_LOCKED and
+               TSK.tasks_state(soft_req.caller_id) /= TASK_STATE_SLEEPING_DEEP
             then
                soft_handler (soft_req);
                ewok.sched.request_schedule;
@@ -298,6 +554,7 @@ is
       end loop;
 
    end main_task;
+#end if;
 
 
 end ewok.softirq;
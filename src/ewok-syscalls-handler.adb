@@ -45,6 +45,18 @@ with ewok.debug;
 with ewok.syscalls.dma;
 #end if;
 
+#if CONFIG_KERNEL_ISR_LATENCY_STATS
+with ewok.syscalls.latency;
+#end if;
+
+#if CONFIG_KERNEL_STACK_WATERMARK
+with ewok.syscalls.watermark;
+#end if;
+
+#if CONFIG_KERNEL_BENCH
+with ewok.bench;
+#end if;
+
 with m4.cpu.instructions;
 
 package body ewok.syscalls.handler
@@ -59,6 +71,7 @@ is
    is
       current_id     : constant t_task_id       := ewok.sched.current_task_id;
       current_a      : constant t_task_access   := ewok.tasks.tasks_list(current_id)'access;
+      current_mode   : constant t_task_mode     := ewok.tasks.tasks_mode(current_id);
       svc_params_a   : t_parameters_access      := NULL;
       svc            : t_svc;
    begin
@@ -70,7 +83,7 @@ is
       -- or 'current_a.all.isr_ctx.frame_a')
       --
 
-      if current_a.all.mode = TASK_MODE_MAINTHREAD then
+      if current_mode = TASK_MODE_MAINTHREAD then
          current_a.all.ctx.frame_a := frame_a;
       else
          current_a.all.isr_ctx.frame_a := frame_a;
@@ -95,10 +108,13 @@ is
                ewok.tasks.set_state
                  (current_id, TASK_MODE_MAINTHREAD, TASK_STATE_FAULT);
                set_return_value
-                 (current_id, current_a.all.mode, SYS_E_DENIED);
+                 (current_id, current_mode, SYS_E_DENIED);
                return frame_a;
             end if;
             svc := svc_type;
+#if CONFIG_KERNEL_BENCH
+            ewok.bench.set_svc (svc);
+#end if;
          end;
       end;
 
@@ -108,7 +124,7 @@ is
 
       if
          ewok.sanitize.is_range_in_data_region
-           (frame_a.all.R0, t_parameters'size/8, current_id, current_a.all.mode)
+           (frame_a.all.R0, t_parameters'size/8, current_id, current_mode)
       then
          svc_params_a := to_parameters_access (frame_a.all.R0);
       else
@@ -127,7 +143,7 @@ is
             ewok.tasks.set_state
               (current_id, TASK_MODE_MAINTHREAD, TASK_STATE_RUNNABLE);
             set_return_value
-              (current_id, current_a.all.mode, SYS_E_DENIED);
+              (current_id, current_mode, SYS_E_DENIED);
             return frame_a;
          end if;
       end if;
@@ -139,151 +155,151 @@ is
       case svc is
 
          when SVC_EXIT           =>
-            ewok.syscalls.exiting.svc_exit (current_id, current_a.all.mode);
+            ewok.syscalls.exiting.svc_exit (current_id, current_mode);
             return ewok.sched.do_schedule (frame_a);
 
          when SVC_YIELD          =>
-            ewok.syscalls.yield.svc_yield (current_id, current_a.all.mode);
+            ewok.syscalls.yield.svc_yield (current_id, current_mode);
             return frame_a;
 
          when SVC_GET_TIME       =>
             ewok.syscalls.gettick.svc_gettick
-              (current_id, svc_params_a.all, current_a.all.mode);
+              (current_id, svc_params_a.all, current_mode);
             return frame_a;
 
          when SVC_RESET          =>
-            ewok.syscalls.reset.svc_reset (current_id, current_a.all.mode);
+            ewok.syscalls.reset.svc_reset (current_id, current_mode);
             return frame_a;
 
          when SVC_SLEEP          =>
             ewok.syscalls.sleep.svc_sleep
-              (current_id, svc_params_a.all, current_a.all.mode);
+              (current_id, svc_params_a.all, current_mode);
             return frame_a;
 
          when SVC_GET_RANDOM     =>
             ewok.syscalls.rng.svc_get_random
-              (current_id, svc_params_a.all, current_a.all.mode);
+              (current_id, svc_params_a.all, current_mode);
             return frame_a;
 
          when SVC_LOG            =>
 
             ewok.syscalls.log.svc_log
-              (current_id, svc_params_a.all, current_a.all.mode);
+              (current_id, svc_params_a.all, current_mode);
             return frame_a;
 
          when SVC_REGISTER_DEVICE   =>
             ewok.syscalls.init.svc_register_device
-              (current_id, svc_params_a.all, current_a.all.mode);
+              (current_id, svc_params_a.all, current_mode);
             return frame_a;
 
          when SVC_REGISTER_DMA      =>
 #if CONFIG_KERNEL_DMA_ENABLE
             ewok.syscalls.dma.svc_register_dma
-              (current_id, svc_params_a.all, current_a.all.mode);
+              (current_id, svc_params_a.all, current_mode);
 #else
-            set_return_value (current_id, current_a.all.mode, SYS_E_DENIED);
+            set_return_value (current_id, current_mode, SYS_E_DENIED);
 #end if;
             return frame_a;
 
          when SVC_REGISTER_DMA_SHM  =>
 #if CONFIG_KERNEL_DMA_ENABLE
             ewok.syscalls.dma.svc_register_dma_shm
-              (current_id, svc_params_a.all, current_a.all.mode);
+              (current_id, svc_params_a.all, current_mode);
 #else
-            set_return_value (current_id, current_a.all.mode, SYS_E_DENIED);
+            set_return_value (current_id, current_mode, SYS_E_DENIED);
 #end if;
             return frame_a;
 
          when SVC_GET_TASKID =>
             ewok.syscalls.init.svc_get_taskid
-              (current_id, svc_params_a.all, current_a.all.mode);
+              (current_id, svc_params_a.all, current_mode);
             return frame_a;
 
          when SVC_INIT_DONE      =>
-            ewok.syscalls.init.svc_init_done (current_id, current_a.all.mode);
+            ewok.syscalls.init.svc_init_done (current_id, current_mode);
             return frame_a;
 
          when SVC_IPC_RECV_SYNC  =>
             ewok.syscalls.ipc.svc_ipc_do_recv
-              (current_id, svc_params_a.all, true, current_a.all.mode);
+              (current_id, svc_params_a.all, true, current_mode);
             return ewok.sched.do_schedule (frame_a);
 
          when SVC_IPC_SEND_SYNC  =>
             ewok.syscalls.ipc.svc_ipc_do_send
-              (current_id, svc_params_a.all, true, current_a.all.mode);
+              (current_id, svc_params_a.all, true, current_mode);
             return ewok.sched.do_schedule (frame_a);
 
          when SVC_IPC_RECV_ASYNC =>
             ewok.syscalls.ipc.svc_ipc_do_recv
-              (current_id, svc_params_a.all, false, current_a.all.mode);
+              (current_id, svc_params_a.all, false, current_mode);
             return ewok.sched.do_schedule (frame_a);
 
          when SVC_IPC_SEND_ASYNC =>
             ewok.syscalls.ipc.svc_ipc_do_send
-              (current_id, svc_params_a.all, false, current_a.all.mode);
+              (current_id, svc_params_a.all, false, current_mode);
             return ewok.sched.do_schedule (frame_a);
 
          when SVC_GPIO_SET       =>
-            ewok.syscalls.cfg.gpio.svc_gpio_set (current_id, svc_params_a.all, current_a.all.mode);
+            ewok.syscalls.cfg.gpio.svc_gpio_set (current_id, svc_params_a.all, current_mode);
             return frame_a;
 
          when SVC_GPIO_GET       =>
-            ewok.syscalls.cfg.gpio.svc_gpio_get (current_id, svc_params_a.all, current_a.all.mode);
+            ewok.syscalls.cfg.gpio.svc_gpio_get (current_id, svc_params_a.all, current_mode);
             return frame_a;
 
          when SVC_GPIO_UNLOCK_EXTI =>
             ewok.syscalls.cfg.gpio.svc_gpio_unlock_exti
-              (current_id, svc_params_a.all, current_a.all.mode);
+              (current_id, svc_params_a.all, current_mode);
             return frame_a;
 
          when SVC_DMA_RECONF  =>
 #if CONFIG_KERNEL_DMA_ENABLE
             ewok.syscalls.dma.svc_dma_reconf
-              (current_id, svc_params_a.all, current_a.all.mode);
+              (current_id, svc_params_a.all, current_mode);
 #else
-            set_return_value (current_id, current_a.all.mode, SYS_E_DENIED);
+            set_return_value (current_id, current_mode, SYS_E_DENIED);
 #end if;
             return frame_a;
 
          when SVC_DMA_RELOAD  =>
 #if CONFIG_KERNEL_DMA_ENABLE
             ewok.syscalls.dma.svc_dma_reload
-              (current_id, svc_params_a.all, current_a.all.mode);
+              (current_id, svc_params_a.all, current_mode);
 #else
-            set_return_value (current_id, current_a.all.mode, SYS_E_DENIED);
+            set_return_value (current_id, current_mode, SYS_E_DENIED);
 #end if;
             return frame_a;
 
          when SVC_DMA_DISABLE =>
 #if CONFIG_KERNEL_DMA_ENABLE
             ewok.syscalls.dma.svc_dma_disable
-              (current_id, svc_params_a.all, current_a.all.mode);
+              (current_id, svc_params_a.all, current_mode);
 #else
-            set_return_value (current_id, current_a.all.mode, SYS_E_DENIED);
+            set_return_value (current_id, current_mode, SYS_E_DENIED);
 #end if;
             return frame_a;
 
          when SVC_DEV_MAP     =>
             ewok.syscalls.cfg.dev.svc_dev_map
-              (current_id, svc_params_a.all, current_a.all.mode);
+              (current_id, svc_params_a.all, current_mode);
             return frame_a;
 
          when SVC_DEV_UNMAP   =>
             ewok.syscalls.cfg.dev.svc_dev_unmap
-              (current_id, svc_params_a.all, current_a.all.mode);
+              (current_id, svc_params_a.all, current_mode);
             return frame_a;
 
          when SVC_DEV_RELEASE =>
             ewok.syscalls.cfg.dev.svc_dev_release
-              (current_id, svc_params_a.all, current_a.all.mode);
+              (current_id, svc_params_a.all, current_mode);
             return frame_a;
 
          when SVC_LOCK_ENTER  =>
-            ewok.syscalls.lock.svc_lock_enter (current_id, current_a.all.mode);
+            ewok.syscalls.lock.svc_lock_enter (current_id, current_mode);
             return frame_a;
 
          when SVC_LOCK_EXIT   =>
-            ewok.syscalls.lock.svc_lock_exit (current_id, current_a.all.mode);
+            ewok.syscalls.lock.svc_lock_exit (current_id, current_mode);
             return frame_a;
 
          when SVC_PANIC       =>
@@ -292,7 +308,80 @@ is
 
          when SVC_ALARM       =>
             ewok.syscalls.alarm.svc_alarm
-              (current_id, svc_params_a.all, current_a.all.mode);
+              (current_id, svc_params_a.all, current_mode);
+            return frame_a;
+
+         when SVC_ISR_LATENCY =>
+#if CONFIG_KERNEL_ISR_LATENCY_STATS
+            ewok.syscalls.latency.svc_isr_latency
+              (current_id, svc_params_a.all, current_mode);
+#else
+            set_return_value (current_id, current_mode, SYS_E_DENIED);
+#end if;
+            return frame_a;
+
+         when SVC_DMA_CHAIN   =>
+#if CONFIG_KERNEL_DMA_CHAINS
+            ewok.syscalls.dma.svc_dma_chain
+              (current_id, svc_params_a.all, current_mode);
+#else
+            set_return_value (current_id, current_mode, SYS_E_DENIED);
+#end if;
+            return frame_a;
+
+         when SVC_REGISTER_DMA_BUFFER =>
+#if CONFIG_KERNEL_DMA_ENABLE
+            ewok.syscalls.dma.svc_register_dma_buffer
+              (current_id, svc_params_a.all, current_mode);
+#else
+            set_return_value (current_id, current_mode, SYS_E_DENIED);
+#end if;
+            return frame_a;
+
+         when SVC_DMA_RECONF_BUFFER   =>
+#if CONFIG_KERNEL_DMA_ENABLE
+            ewok.syscalls.dma.svc_dma_reconf_buffer
+              (current_id, svc_params_a.all, current_mode);
+#else
+            set_return_value (current_id, current_mode, SYS_E_DENIED);
+#end if;
+            return frame_a;
+
+         when SVC_GPIO_EXTI_TIMESTAMPS =>
+#if CONFIG_KERNEL_EXTI_TIMESTAMPS
+            ewok.syscalls.cfg.gpio.svc_gpio_exti_timestamps
+              (current_id, svc_params_a.all, current_mode);
+#else
+            set_return_value (current_id, current_mode, SYS_E_DENIED);
+#end if;
+            return frame_a;
+
+         when SVC_GPIO_SET_MASKED   =>
+            ewok.syscalls.cfg.gpio.svc_gpio_set_masked
+              (current_id, svc_params_a.all, current_mode);
+            return frame_a;
+
+         when SVC_GPIO_GET_MASKED   =>
+            ewok.syscalls.cfg.gpio.svc_gpio_get_masked
+              (current_id, svc_params_a.all, current_mode);
+            return frame_a;
+
+         when SVC_MEM_USAGE   =>
+#if CONFIG_KERNEL_STACK_WATERMARK
+            ewok.syscalls.watermark.svc_mem_usage
+              (current_id, svc_params_a.all, current_mode);
+#else
+            set_return_value (current_id, current_mode, SYS_E_DENIED);
+#end if;
+            return frame_a;
+
+         when SVC_ALARM_HR    =>
+#if CONFIG_KERNEL_ALARM_HRTIMER
+            ewok.syscalls.alarm.svc_alarm_hr
+              (current_id, svc_params_a.all, current_mode);
+#else
+            set_return_value (current_id, current_mode, SYS_E_DENIED);
+#end if;
             return frame_a;
 
       end case;
@@ -30,6 +30,9 @@ with ewok.rng;
 with ewok.softirq;
 with ewok.memory;
 with types.c;              use type types.c.t_retval;
+#if CONFIG_KERNEL_STACK_WATERMARK
+with ewok.watermark;
+#end if;
 
 with config.tasks;
 with config.applications; -- Automatically generated
@@ -100,15 +103,14 @@ is
    end create_stack;
 
 
-   procedure set_default_values (tsk : out t_task)
+   procedure set_default_values (id : in ewok.tasks_shared.t_task_id)
    is
+      tsk : t_task renames tasks_list(id);
    begin
       tsk.name              := "          ";
       tsk.entry_point       := 0;
       tsk.ttype             := TASK_TYPE_USER;
-      tsk.mode              := TASK_MODE_MAINTHREAD;
       tsk.id                := ID_UNUSED;
-      tsk.prio              := 0;
 
 #if CONFIG_KERNEL_DOMAIN
       tsk.domain            := 0;
@@ -131,6 +133,11 @@ is
 
       tsk.num_dma_id        := 0;
       tsk.dma_id            := (others => ewok.dma_shared.ID_DMA_UNUSED);
+      tsk.dma_buffers       :=
+        (others => (base        => 0,
+                    size        => 0,
+                    access_type => ewok.exported.dma.SHM_ACCESS_READ,
+                    owner_id    => ID_UNUSED));
 
       tsk.num_devs          := 0;
       tsk.devices           := (others => (ewok.devices_shared.ID_DEV_UNUSED, false));
@@ -140,11 +147,14 @@ is
       tsk.txt_start         := 0;
       tsk.txt_end           := 0;
       tsk.stack_size        := 0;
-      tsk.state             := TASK_STATE_EMPTY;
-      tsk.isr_state         := TASK_STATE_EMPTY;
       tsk.ipc_endpoint_id   := (others => ID_ENDPOINT_UNUSED);
       tsk.ctx.frame_a       := NULL;
-      tsk.isr_ctx           := t_isr_context'(0, ID_DEV_UNUSED, ISR_STANDARD, NULL);
+      tsk.isr_ctx           := t_isr_context'(others => <>);
+
+      tasks_state(id)       := TASK_STATE_EMPTY;
+      tasks_isr_state(id)   := TASK_STATE_EMPTY;
+      tasks_mode(id)        := TASK_MODE_MAINTHREAD;
+      tasks_prio(id)        := 0;
    end set_default_values;
 
 
@@ -154,7 +164,7 @@ is
    begin
 
       -- Setting default values
-      set_default_values (tasks_list(ID_SOFTIRQ));
+      set_default_values (ID_SOFTIRQ);
 
       tasks_list(ID_SOFTIRQ).name := softirq_task_name;
 
@@ -169,6 +179,11 @@ is
       tasks_list(ID_SOFTIRQ).ttype  := TASK_TYPE_KERNEL;
       tasks_list(ID_SOFTIRQ).id     := ID_SOFTIRQ;
 
+#if CONFIG_KERNEL_STACK_WATERMARK
+      -- Painting the stack (see ewok.watermark)
+      ewok.watermark.paint
+        (STACK_TOP_SOFTIRQ - STACK_SIZE_SOFTIRQ, STACK_SIZE_SOFTIRQ);
+#else
       -- Zeroing the stack
       declare
          stack : byte_array(1 .. STACK_SIZE_SOFTIRQ)
@@ -176,6 +191,7 @@ is
       begin
          stack := (others => 0);
       end;
+#end if;
 
       -- Create the initial stack frame and set the stack pointer
       create_stack
@@ -185,8 +201,8 @@ is
          tasks_list(ID_SOFTIRQ).ctx.frame_a);
 
       tasks_list(ID_SOFTIRQ).stack_size   := STACK_SIZE_SOFTIRQ;
-      tasks_list(ID_SOFTIRQ).state        := TASK_STATE_IDLE;
-      tasks_list(ID_SOFTIRQ).isr_state    := TASK_STATE_IDLE;
+      tasks_state(ID_SOFTIRQ)        := TASK_STATE_IDLE;
+      tasks_isr_state(ID_SOFTIRQ)    := TASK_STATE_IDLE;
 
       for i in tasks_list(ID_SOFTIRQ).ipc_endpoint_id'range loop
          tasks_list(ID_SOFTIRQ).ipc_endpoint_id(i)   := ID_ENDPOINT_UNUSED;
@@ -207,7 +223,7 @@ is
    begin
 
       -- Setting default values
-      set_default_values (tasks_list(ID_KERNEL));
+      set_default_values (ID_KERNEL);
 
       tasks_list(ID_KERNEL).name := idle_task_name;
 
@@ -220,9 +236,14 @@ is
       end if;
 
       tasks_list(ID_KERNEL).ttype  := TASK_TYPE_KERNEL;
-      tasks_list(ID_KERNEL).mode   := TASK_MODE_MAINTHREAD;
+      tasks_mode(ID_KERNEL)   := TASK_MODE_MAINTHREAD;
       tasks_list(ID_KERNEL).id     := ID_KERNEL;
 
+#if CONFIG_KERNEL_STACK_WATERMARK
+      -- Painting the stack (see ewok.watermark)
+      ewok.watermark.paint
+        (STACK_TOP_IDLE - STACK_SIZE_IDLE, STACK_SIZE_IDLE);
+#else
       -- Zeroing the stack
       declare
          stack : byte_array(1 .. STACK_SIZE_IDLE)
@@ -230,6 +251,7 @@ is
       begin
          stack := (others => 0);
       end;
+#end if;
 
       -- Create the initial stack frame and set the stack pointer
       create_stack
@@ -239,8 +261,8 @@ is
          tasks_list(ID_KERNEL).ctx.frame_a);
 
       tasks_list(ID_KERNEL).stack_size   := STACK_SIZE_IDLE;
-      tasks_list(ID_KERNEL).state        := TASK_STATE_RUNNABLE;
-      tasks_list(ID_KERNEL).isr_state    := TASK_STATE_IDLE;
+      tasks_state(ID_KERNEL)        := TASK_STATE_RUNNABLE;
+      tasks_isr_state(ID_KERNEL)    := TASK_STATE_IDLE;
 
       for i in tasks_list(ID_KERNEL).ipc_endpoint_id'range loop
          tasks_list(ID_KERNEL).ipc_endpoint_id(i)   := ID_ENDPOINT_UNUSED;
@@ -263,7 +285,7 @@ is
       ok          : boolean;
    begin
 
-      if config.applications.t_real_task_id'last > ID_APP7 then
+      if config.applications.t_real_task_id'last > t_user_task_id'last then
          debug.panic ("Too many apps");
       end if;
 
@@ -271,7 +293,7 @@ is
 
       for id in config.applications.list'range loop
 
-         set_default_values (tasks_list(id));
+         set_default_values (id);
 
          tasks_list(id).name := config.applications.list(id).name;
 
@@ -288,7 +310,7 @@ is
          tasks_list(id).id    := id;
 
 
-         tasks_list(id).prio  := config.applications.list(id).priority;
+         tasks_prio(id)  := config.applications.list(id).priority;
 
 #if CONFIG_KERNEL_DOMAIN
          tasks_list(id).domain   := config.applications.list(id).domain;
@@ -305,6 +327,7 @@ is
             + to_unsigned_32(config.applications.list(id).data_size)
             + to_unsigned_32(config.applications.list(id).bss_size)
             + to_unsigned_32(config.applications.list(id).heap_size)
+            + to_unsigned_32(config.applications.list(id).isr_stack_size)
             + config.memlayout.list(id).ram_free_space;
 
          tasks_list(id).txt_start :=
@@ -329,8 +352,8 @@ is
          tasks_list(id).stack_size     :=
             config.applications.list(id).stack_size;
 
-         tasks_list(id).state       := TASK_STATE_RUNNABLE;
-         tasks_list(id).isr_state   := TASK_STATE_IDLE;
+         tasks_state(id)       := TASK_STATE_RUNNABLE;
+         tasks_isr_state(id)   := TASK_STATE_IDLE;
 
          for i in tasks_list(id).ipc_endpoint_id'range loop
             tasks_list(id).ipc_endpoint_id(i)   := ID_ENDPOINT_UNUSED;
@@ -346,6 +369,20 @@ is
             stack := (others => 0);
          end;
 
+#if CONFIG_KERNEL_STACK_WATERMARK
+         -- Painting the stack and the heap (see ewok.watermark). The heap
+         -- is located just after the .bss
+         ewok.watermark.paint
+           (tasks_list(id).stack_bottom,
+            to_unsigned_32(config.applications.list(id).stack_size));
+
+         ewok.watermark.paint
+           (tasks_list(id).stack_top
+            + to_unsigned_32(config.applications.list(id).data_size)
+            + to_unsigned_32(config.applications.list(id).bss_size),
+            to_unsigned_32(config.applications.list(id).heap_size));
+#end if;
+
          --
          -- Create the initial stack frame and set the stack pointer
          --
@@ -370,6 +407,39 @@ is
             + config.applications.list(id).text_offset
             + config.applications.list(id).isr_entrypoint_offset;
 
+#if CONFIG_KERNEL_ISR_PER_TASK_STACK
+         -- The task's ISR stack is located just after its heap
+         if config.applications.list(id).isr_stack_size = 0 then
+            debug.panic ("No ISR stack reserved for task " & tasks_list(id).name);
+         end if;
+
+         tasks_list(id).isr_ctx.stack_bottom :=
+            config.memlayout.apps_region.ram_memory_addr
+            + config.applications.list(id).data_offset
+            + to_unsigned_32(config.applications.list(id).stack_size)
+            + to_unsigned_32(config.applications.list(id).data_size)
+            + to_unsigned_32(config.applications.list(id).bss_size)
+            + to_unsigned_32(config.applications.list(id).heap_size);
+
+         tasks_list(id).isr_ctx.stack_top :=
+            tasks_list(id).isr_ctx.stack_bottom
+            + to_unsigned_32(config.applications.list(id).isr_stack_size);
+
+#if CONFIG_KERNEL_STACK_WATERMARK
+         ewok.watermark.paint
+           (tasks_list(id).isr_ctx.stack_bottom,
+            to_unsigned_32(config.applications.list(id).isr_stack_size));
+#else
+         declare
+            stack : byte_array
+              (1 .. to_unsigned_32(config.applications.list(id).isr_stack_size))
+               with address => to_address (tasks_list(id).isr_ctx.stack_bottom);
+         begin
+            stack := (others => 0);
+         end;
+#end if;
+#end if;
+
 
          pragma DEBUG (debug.log (debug.INFO, "Created task " & tasks_list(id).name
             & " (pc: " & system_address'image (tasks_list(id).entry_point)
@@ -452,9 +522,9 @@ is
    is
    begin
       if mode = TASK_MODE_MAINTHREAD then
-         return tasks_list(id).state;
+         return tasks_state(id);
       else
-         return tasks_list(id).isr_state;
+         return tasks_isr_state(id);
       end if;
    end get_state;
 
@@ -466,9 +536,9 @@ is
    is
    begin
       if mode = TASK_MODE_MAINTHREAD then
-         tasks_list(id).state := state;
+         tasks_state(id) := state;
       else
-         tasks_list(id).isr_state := state;
+         tasks_isr_state(id) := state;
       end if;
    end set_state;
 
@@ -478,7 +548,7 @@ is
       return t_task_mode
    is
    begin
-      return tasks_list(id).mode;
+      return tasks_mode(id);
    end get_mode;
 
 
@@ -487,7 +557,7 @@ is
       mode   : in   ewok.tasks_shared.t_task_mode)
    is
    begin
-      tasks_list(id).mode := mode;
+      tasks_mode(id) := mode;
    end set_mode;
 
 
@@ -634,13 +704,17 @@ is
    begin
 
       for id in tasks_list'range loop
-         set_default_values (tasks_list(id));
+         set_default_values (id);
       end loop;
 
       init_idle_task;
       init_softirq_task;
       init_apps;
 
+#if CONFIG_KERNEL_STACK_WATERMARK
+      ewok.watermark.init;
+#end if;
+
       for id in config.applications.list'range loop
          config.tasks.copy_data_to_ram(id);
          config.tasks.zeroify_bss(id);
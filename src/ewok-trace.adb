@@ -0,0 +1,116 @@
+--
+-- Copyright 2018 The wookey project team <wookey@ssi.gouv.fr>
+--   - Ryad     Benadjila
+--   - Arnauld  Michelizza
+--   - Mathieu  Renard
+--   - Philippe Thierry
+--   - Philippe Trebuchet
+--
+-- Licensed under the Apache License, Version 2.0 (the "License");
+-- you may not use this file except in compliance with the License.
+-- You may obtain a copy of the License at
+--
+--     http://www.apache.org/licenses/LICENSE-2.0
+--
+--     Unless required by applicable law or agreed to in writing, software
+--     distributed under the License is distributed on an "AS IS" BASIS,
+--     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+--     See the License for the specific language governing permissions and
+--     limitations under the License.
+--
+--
+
+
+#if CONFIG_KERNEL_TRACE
+with soc.dwt;
+with m4.cpu;
+#end if;
+
+package body ewok.trace
+   with spark_mode => off
+is
+
+#if CONFIG_KERNEL_TRACE
+   TRACE_MAGIC       : constant unsigned_32 := 16#4543_5254#; -- "TRCE"
+   TRACE_BUFFER_SIZE : constant := $CONFIG_KERNEL_TRACE_BUFFER_SIZE;
+
+   type t_trace_record is record
+      stamp    : unsigned_32;    -- DWT cycle counter
+      event    : t_trace_event;
+      reserved : unsigned_16;
+      arg1     : unsigned_32;
+      arg2     : unsigned_32;
+      arg3     : unsigned_32;
+   end record
+      with size => 160;
+
+   for t_trace_record use record
+      stamp    at 0  range 0 .. 31;
+      event    at 4  range 0 .. 15;
+      reserved at 4  range 16 .. 31;
+      arg1     at 8  range 0 .. 31;
+      arg2     at 12 range 0 .. 31;
+      arg3     at 16 range 0 .. 31;
+   end record;
+
+   type t_trace_records is
+      array (0 .. TRACE_BUFFER_SIZE - 1) of t_trace_record;
+
+   -- The records are written in a ring. 'count' is the total number of
+   -- recorded events: the oldest record is at index 'count mod size' once
+   -- the ring is full
+   type t_trace_buffer is record
+      magic    : unsigned_32;
+      count    : unsigned_32;
+      size     : unsigned_32;
+      records  : t_trace_records;
+   end record;
+
+   trace_buffer : t_trace_buffer :=
+     (magic    => TRACE_MAGIC,
+      count    => 0,
+      size     => TRACE_BUFFER_SIZE,
+      records  => (others => (0, TRACE_SCHED_SWITCH, 0, 0, 0, 0)))
+      with export, external_name => "ewok_trace_buffer";
+
+
+   procedure event
+     (ev       : in  t_trace_event;
+      arg1     : in  unsigned_32 := 0;
+      arg2     : in  unsigned_32 := 0;
+      arg3     : in  unsigned_32 := 0)
+   is
+      primask  : constant unsigned_32 := m4.cpu.get_primask_register;
+      index    : natural;
+      stamp    : unsigned_32;
+   begin
+      soc.dwt.get_cycles_32 (stamp);
+
+      m4.cpu.disable_irq;
+
+      index := natural (trace_buffer.count mod TRACE_BUFFER_SIZE);
+      trace_buffer.records(index) :=
+        (stamp    => stamp,
+         event    => ev,
+         reserved => 0,
+         arg1     => arg1,
+         arg2     => arg2,
+         arg3     => arg3);
+      trace_buffer.count := trace_buffer.count + 1;
+
+      m4.cpu.set_primask_register (primask);
+   end event;
+#else
+   procedure event
+     (ev       : in  t_trace_event;
+      arg1     : in  unsigned_32 := 0;
+      arg2     : in  unsigned_32 := 0;
+      arg3     : in  unsigned_32 := 0)
+   is
+      pragma unreferenced (ev, arg1, arg2, arg3);
+   begin
+      null;
+   end event;
+#end if;
+
+end ewok.trace;
@@ -0,0 +1,202 @@
+--
+-- Copyright 2018 The wookey project team <wookey@ssi.gouv.fr>
+--   - Ryad     Benadjila
+--   - Arnauld  Michelizza
+--   - Mathieu  Renard
+--   - Philippe Thierry
+--   - Philippe Trebuchet
+--
+-- Licensed under the Apache License, Version 2.0 (the "License");
+-- you may not use this file except in compliance with the License.
+-- You may obtain a copy of the License at
+--
+--     http://www.apache.org/licenses/LICENSE-2.0
+--
+--     Unless required by applicable law or agreed to in writing, software
+--     distributed under the License is distributed on an "AS IS" BASIS,
+--     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+--     See the License for the specific language governing permissions and
+--     limitations under the License.
+--
+--
+
+
+with ewok.tasks;
+with ewok.layout;
+#if CONFIG_KERNEL_STACK_WATERMARK_DUMP
+with ewok.debug;
+#end if;
+with config.applications;  use config.applications;
+with config.memlayout;
+
+package body ewok.watermark
+   with spark_mode => off
+is
+
+   type t_words is array (unsigned_32 range <>) of unsigned_32;
+
+
+   procedure paint
+     (addr     : in  system_address;
+      size     : in  unsigned_32)
+   is
+      words : t_words (1 .. size / 4)
+         with address => to_address (addr);
+   begin
+      words := (others => PAINT_PATTERN);
+   end paint;
+
+
+   function stack_usage
+     (bottom   : system_address;
+      size     : unsigned_32)
+      return unsigned_32
+   is
+      words : t_words (1 .. size / 4)
+         with address => to_address (bottom);
+   begin
+      for i in words'range loop
+         if words(i) /= PAINT_PATTERN then
+            return size - (i - 1) * 4;
+         end if;
+      end loop;
+      return 0;
+   end stack_usage;
+
+
+   function heap_usage
+     (addr     : system_address;
+      size     : unsigned_32)
+      return unsigned_32
+   is
+      words : t_words (1 .. size / 4)
+         with address => to_address (addr);
+   begin
+      for i in reverse words'range loop
+         if words(i) /= PAINT_PATTERN then
+            return i * 4;
+         end if;
+      end loop;
+      return 0;
+   end heap_usage;
+
+
+   procedure init
+   is
+   begin
+#if not CONFIG_KERNEL_ISR_PER_TASK_STACK
+      -- The shared ISR stack is repainted each time its owner changes
+      paint (ewok.layout.STACK_BOTTOM_TASK_ISR,
+             ewok.layout.STACK_SIZE_TASK_ISR);
+#else
+      null;
+#end if;
+   end init;
+
+
+#if not CONFIG_KERNEL_ISR_PER_TASK_STACK
+   function isr_stack_usage return unsigned_32
+   is
+      used : constant unsigned_32 :=
+         stack_usage (ewok.layout.STACK_BOTTOM_TASK_ISR,
+                      ewok.layout.STACK_SIZE_TASK_ISR);
+   begin
+      return (if used > isr_stack_max then used else isr_stack_max);
+   end isr_stack_usage;
+
+
+   procedure repaint_isr_stack
+   is
+   begin
+      isr_stack_max := isr_stack_usage;
+      paint (ewok.layout.STACK_BOTTOM_TASK_ISR,
+             ewok.layout.STACK_SIZE_TASK_ISR);
+   end repaint_isr_stack;
+#end if;
+
+
+   procedure get_usage
+     (id       : in  ewok.tasks_shared.t_task_id;
+      usage    : out t_mem_usage)
+   is
+      heap_addr : system_address;
+   begin
+
+      if not ewok.tasks.is_real_user (id) then
+         usage := (others => 0);
+         return;
+      end if;
+
+      usage.stack_size  := to_unsigned_32 (list(id).stack_size);
+      usage.stack_used  :=
+         stack_usage (ewok.tasks.tasks_list(id).stack_bottom,
+                      usage.stack_size);
+
+#if CONFIG_KERNEL_ISR_PER_TASK_STACK
+      usage.isr_stack_size := to_unsigned_32 (list(id).isr_stack_size);
+      usage.isr_stack_used :=
+         stack_usage (ewok.tasks.tasks_list(id).isr_ctx.stack_bottom,
+                      usage.isr_stack_size);
+#else
+      -- The ISR stack is shared by every task
+      usage.isr_stack_size := ewok.layout.STACK_SIZE_TASK_ISR;
+      usage.isr_stack_used := isr_stack_usage;
+#end if;
+
+      usage.data_size   := to_unsigned_32 (list(id).data_size);
+      usage.bss_size    := to_unsigned_32 (list(id).bss_size);
+      usage.heap_size   := to_unsigned_32 (list(id).heap_size);
+
+      -- The heap is located just after the .bss
+      heap_addr :=
+         ewok.tasks.tasks_list(id).stack_bottom
+         + usage.stack_size
+         + usage.data_size
+         + usage.bss_size;
+
+      usage.heap_used   := heap_usage (heap_addr, usage.heap_size);
+      usage.free_space  := config.memlayout.list(id).ram_free_space;
+
+   end get_usage;
+
+
+#if CONFIG_KERNEL_STACK_WATERMARK_DUMP
+   procedure dump
+   is
+      usage : t_mem_usage;
+   begin
+
+      for id in config.applications.list'range loop
+         get_usage (id, usage);
+         debug.log (debug.INFO, ewok.tasks.tasks_list(id).name
+            & ": stack" & unsigned_32'image (usage.stack_used)
+            & " /" & unsigned_32'image (usage.stack_size)
+            & ", isr stack" & unsigned_32'image (usage.isr_stack_used)
+            & " /" & unsigned_32'image (usage.isr_stack_size)
+            & ", data" & unsigned_32'image (usage.data_size)
+            & ", bss" & unsigned_32'image (usage.bss_size)
+            & ", heap" & unsigned_32'image (usage.heap_used)
+            & " /" & unsigned_32'image (usage.heap_size)
+            & ", free" & unsigned_32'image (usage.free_space));
+      end loop;
+
+      debug.log (debug.INFO, "kernel: idle stack"
+         & unsigned_32'image (stack_usage
+              (ewok.layout.STACK_TOP_IDLE - ewok.layout.STACK_SIZE_IDLE,
+               ewok.layout.STACK_SIZE_IDLE))
+         & " /" & unsigned_32'image (ewok.layout.STACK_SIZE_IDLE)
+         & ", softirq stack"
+         & unsigned_32'image (stack_usage
+              (ewok.layout.STACK_TOP_SOFTIRQ - ewok.layout.STACK_SIZE_SOFTIRQ,
+               ewok.layout.STACK_SIZE_SOFTIRQ))
+         & " /" & unsigned_32'image (ewok.layout.STACK_SIZE_SOFTIRQ)
+#if not CONFIG_KERNEL_ISR_PER_TASK_STACK
+         & ", isr stack" & unsigned_32'image (isr_stack_usage)
+         & " /" & unsigned_32'image (ewok.layout.STACK_SIZE_TASK_ISR)
+#end if;
+         );
+
+   end dump;
+#end if;
+
+end ewok.watermark;
@@ -31,10 +31,19 @@ with soc.rng;
 with soc.system;
 
 with ewok.debug;
+#if CONFIG_KERNEL_BOOT_PROFILE
+with ewok.boottime;
+#end if;
 with ewok.dma;
 with ewok.exti;
 with ewok.interrupts;
 with ewok.memory;
+#if CONFIG_KERNEL_RNG_POOL
+with ewok.rng;
+#end if;
+#if CONFIG_KERNEL_ALARM_HRTIMER
+with ewok.hralarm;
+#end if;
 with ewok.softirq;
 with ewok.sched;
 with ewok.tasks;
@@ -55,11 +64,21 @@ begin
 
    m4.cpu.disable_irq;
 
+   -- Initialize DWT (required for precise time measurement). Started
+   -- first to time the boot phases.
+   soc.dwt.init;
+
    -- Initialize interrupts, handlers & priorities
    ewok.interrupts.init;
+#if CONFIG_KERNEL_BOOT_PROFILE
+   ewok.boottime.mark (ewok.boottime.BOOT_INTERRUPTS);
+#end if;
 
    -- Initialize system Clock
    m4.systick.init;
+#if CONFIG_KERNEL_BOOT_PROFILE
+   ewok.boottime.mark (ewok.boottime.BOOT_SYSTICK);
+#end if;
 
    -- Configure the USART for debugging purpose
 #if CONFIG_KERNEL_SERIAL
@@ -72,26 +91,47 @@ begin
 #else
    raise program_error;
 #end if;
+#end if;
+#if CONFIG_KERNEL_BOOT_PROFILE
+   ewok.boottime.mark (ewok.boottime.BOOT_CONSOLE);
 #end if;
 
-   -- Initialize DWT (required for precise time measurement)
-   soc.dwt.init;
-
-   -- Initialize the platform TRNG
+   -- Initialize the platform TRNG. The first random word is waited for
+   -- on first use.
    soc.rng.init (ok);
    if not ok then
       pragma DEBUG (ewok.debug.log (ewok.debug.ERROR, "Unable to use TRNG"));
+#if CONFIG_KERNEL_RNG_POOL
+   else
+      ewok.rng.init;
+#end if;
    end if;
+#if CONFIG_KERNEL_BOOT_PROFILE
+   ewok.boottime.mark (ewok.boottime.BOOT_RNG);
+#end if;
 
    -- Initialize DMA controllers
    ewok.dma.init;
+#if CONFIG_KERNEL_BOOT_PROFILE
+   ewok.boottime.mark (ewok.boottime.BOOT_DMA);
+#end if;
 
    -- Initialize the EXTIs
    ewok.exti.init;
+#if CONFIG_KERNEL_ALARM_HRTIMER
+   -- Initialize the high resolution alarms timer
+   ewok.hralarm.init;
+#end if;
+#if CONFIG_KERNEL_BOOT_PROFILE
+   ewok.boottime.mark (ewok.boottime.BOOT_EXTI);
+#end if;
 
    -- The kernel is a PIE executable. Its base address is given in first
    -- argument, based on the loader informations
    soc.system.init (VTOR_address);
+#if CONFIG_KERNEL_BOOT_PROFILE
+   ewok.boottime.mark (ewok.boottime.BOOT_SYSTEM);
+#end if;
 
    -- Initialize the memory (MPU or MMU)
    -- After this sequence, the kernel is executed with restricted rights and
@@ -102,12 +142,22 @@ begin
    end if;
 
    m4.cpu.instructions.full_memory_barrier;
+#if CONFIG_KERNEL_BOOT_PROFILE
+   ewok.boottime.mark (ewok.boottime.BOOT_MEMORY);
+#end if;
 
    -- Create user tasks
    ewok.tasks.task_init;
+#if CONFIG_KERNEL_BOOT_PROFILE
+   ewok.boottime.mark (ewok.boottime.BOOT_TASKS);
+#end if;
 
    -- Initialize SOFTIRQ thread
    ewok.softirq.init;
+#if CONFIG_KERNEL_BOOT_PROFILE
+   ewok.boottime.mark (ewok.boottime.BOOT_SOFTIRQ);
+   ewok.boottime.dump;
+#end if;
 
    -- Let's run tasks!
    ewok.sched.init;
@@ -142,4 +142,40 @@ is
       return r.state;
    end state;
 
+
+   procedure merge_item
+     (r        : in out ring;
+      new_item : in     object;
+      success  : out    boolean)
+   is
+      index : ring_range;
+   begin
+
+      success := false;
+
+      if r.state = EMPTY then
+         return;
+      end if;
+
+      -- Pending items are stored from bottom to top. If the ring is full,
+      -- top = bottom, thus the whole buffer is walked through.
+      index := r.bottom;
+      loop
+         if match (r.buf(index), new_item) then
+            merge (r.buf(index), new_item);
+            success := true;
+            return;
+         end if;
+
+         if index = r.buf'last then
+            index := r.buf'first;
+         else
+            index := index + 1;
+         end if;
+
+         exit when index = r.top;
+      end loop;
+
+   end merge_item;
+
 end rings;
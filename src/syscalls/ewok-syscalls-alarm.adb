@@ -25,6 +25,8 @@ with ewok.tasks_shared; use ewok.tasks_shared;
 with ewok.sanitize;
 with ewok.debug;
 with ewok.alarm;
+with ewok.hralarm;
+with ewok.perm;
 
 package body ewok.syscalls.alarm
    with spark_mode => off
@@ -64,5 +66,61 @@ is
       return;
    end svc_alarm;
 
+
+   procedure svc_alarm_hr
+     (caller_id   : in     ewok.tasks_shared.t_task_id;
+      params      : in     t_parameters;
+      mode        : in     ewok.tasks_shared.t_task_mode)
+   is
+      delay_us    : unsigned_32 with address => params(1)'address;
+      period_us   : unsigned_32 with address => params(2)'address;
+      handler     : constant system_address  := params(3);
+   begin
+
+      -- The handler receives the timer counter, in microseconds
+      if not ewok.perm.ressource_is_granted
+               (ewok.perm.PERM_RES_TIM_GETMICRO, caller_id)
+      then
+         pragma DEBUG (debug.log (debug.ERROR, "Permission not granted"));
+         goto ret_denied;
+      end if;
+
+      if delay_us = 0 or handler = 0 then
+         ewok.hralarm.unset_alarm (caller_id);
+         goto ret_ok;
+      end if;
+
+      if delay_us > ewok.hralarm.MAX_DELAY or
+         period_us > ewok.hralarm.MAX_DELAY or
+         (period_us /= 0 and period_us < ewok.hralarm.MIN_PERIOD)
+      then
+         pragma DEBUG (debug.log (debug.ERROR, "Invalid alarm period"));
+         goto ret_inval;
+      end if;
+
+      if not ewok.sanitize.is_word_in_txt_region (handler, caller_id)
+      then
+         pragma DEBUG (debug.log (debug.ERROR, "Handler not in .txt section"));
+         goto ret_denied;
+      end if;
+
+      ewok.hralarm.set_alarm (caller_id, delay_us, period_us, handler);
+
+   <<ret_ok>>
+      set_return_value (caller_id, mode, SYS_E_DONE);
+      ewok.tasks.set_state (caller_id, mode, TASK_STATE_RUNNABLE);
+      return;
+
+   <<ret_inval>>
+      set_return_value (caller_id, mode, SYS_E_INVAL);
+      ewok.tasks.set_state (caller_id, mode, TASK_STATE_RUNNABLE);
+      return;
+
+   <<ret_denied>>
+      set_return_value (caller_id, mode, SYS_E_DENIED);
+      ewok.tasks.set_state (caller_id, mode, TASK_STATE_RUNNABLE);
+      return;
+   end svc_alarm_hr;
+
 end ewok.syscalls.alarm;
 
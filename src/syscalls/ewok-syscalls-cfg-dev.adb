@@ -26,6 +26,10 @@ with ewok.tasks_shared;       use ewok.tasks_shared;
 with ewok.exported.devices;   use ewok.exported.devices;
 with ewok.devices_shared;     use ewok.devices_shared;
 with ewok.devices;
+with ewok.dma;
+#if CONFIG_KERNEL_TRACE_DEVICES
+with ewok.trace;
+#end if;
 
 
 package body ewok.syscalls.cfg.dev
@@ -140,6 +144,13 @@ is
          goto ret_denied;
       end if;
 
+#if CONFIG_KERNEL_TRACE_DEVICES
+      ewok.trace.event
+        (ewok.trace.TRACE_DEV_MAP,
+         to_unsigned_32 (caller_id),
+         t_device_id'pos (dev_id));
+#end if;
+
       set_return_value (caller_id, mode, SYS_E_DONE);
       TSK.set_state (caller_id, mode, TASK_STATE_RUNNABLE);
       return;
@@ -255,6 +266,13 @@ is
          goto ret_denied;
       end if;
 
+#if CONFIG_KERNEL_TRACE_DEVICES
+      ewok.trace.event
+        (ewok.trace.TRACE_DEV_UNMAP,
+         to_unsigned_32 (caller_id),
+         t_device_id'pos (dev_id));
+#end if;
+
       set_return_value (caller_id, mode, SYS_E_DONE);
       TSK.set_state (caller_id, mode, TASK_STATE_RUNNABLE);
       return;
@@ -336,6 +354,10 @@ is
       -- Release GPIOs, EXTIs and interrupts
       ewok.devices.release_device (caller_id, dev_id, ok);
 
+      -- DMA buffers may have been checked against the released device
+      -- (DMA SHM)
+      ewok.dma.release_buffers (caller_id);
+
       set_return_value (caller_id, mode, SYS_E_DONE);
       TSK.set_state (caller_id, mode, TASK_STATE_RUNNABLE);
       return;
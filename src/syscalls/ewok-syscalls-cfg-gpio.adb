@@ -20,6 +20,7 @@
 --
 --
 
+with soc.gpio;
 with ewok.tasks;        use ewok.tasks;
 with ewok.tasks_shared; use ewok.tasks_shared;
 with ewok.gpio;
@@ -199,4 +200,205 @@ is
    end svc_gpio_unlock_exti;
 
 
+   function is_valid_port (port : unsigned_32) return boolean
+   is
+   begin
+      return port <= soc.gpio.t_gpio_port_index'pos
+                       (soc.gpio.t_gpio_port_index'last);
+   end is_valid_port;
+
+
+   -- Write, in a single operation, several pins of a GPIO port
+   procedure svc_gpio_set_masked
+     (caller_id   : in     ewok.tasks_shared.t_task_id;
+      params      : in out t_parameters;
+      mode        : in     ewok.tasks_shared.t_task_mode)
+   is
+      port_num : constant unsigned_32 := params(1);
+      mask     : constant unsigned_32 := params(2);
+      value    : constant unsigned_32 := params(3);
+      port     : soc.gpio.t_gpio_port_index;
+   begin
+
+      -- Task initialization is complete ?
+      if not is_init_done (caller_id) then
+         goto ret_denied;
+      end if;
+
+      -- Valid port and mask ?
+      if not is_valid_port (port_num) or
+         mask = 0 or mask > unsigned_32 (unsigned_16'last)
+      then
+         goto ret_inval;
+      end if;
+
+      port := soc.gpio.t_gpio_port_index'val (port_num);
+
+      -- Do all these GPIOs really belong to the caller ?
+      if not ewok.gpio.belong_to (caller_id, port, unsigned_16 (mask)) then
+         goto ret_denied;
+      end if;
+
+      ewok.gpio.write_pins
+        (port, unsigned_16 (mask), unsigned_16 (value and 16#FFFF#));
+
+      set_return_value (caller_id, mode, SYS_E_DONE);
+      ewok.tasks.set_state (caller_id, mode, TASK_STATE_RUNNABLE);
+      return;
+
+   <<ret_inval>>
+      set_return_value (caller_id, mode, SYS_E_INVAL);
+      ewok.tasks.set_state (caller_id, mode, TASK_STATE_RUNNABLE);
+      return;
+
+   <<ret_denied>>
+      set_return_value (caller_id, mode, SYS_E_DENIED);
+      ewok.tasks.set_state (caller_id, mode, TASK_STATE_RUNNABLE);
+      return;
+   end svc_gpio_set_masked;
+
+
+   -- Read, in a single operation, several pins of a GPIO port
+   procedure svc_gpio_get_masked
+     (caller_id   : in     ewok.tasks_shared.t_task_id;
+      params      : in out t_parameters;
+      mode        : in     ewok.tasks_shared.t_task_mode)
+   is
+      port_num       : constant unsigned_32    := params(1);
+      mask           : constant unsigned_32    := params(2);
+      retval_address : constant system_address := params(3);
+      port           : soc.gpio.t_gpio_port_index;
+   begin
+
+      -- Task initialization is complete ?
+      if not is_init_done (caller_id) then
+         goto ret_denied;
+      end if;
+
+      -- Valid port and mask ?
+      if not is_valid_port (port_num) or
+         mask = 0 or mask > unsigned_32 (unsigned_16'last)
+      then
+         goto ret_inval;
+      end if;
+
+      port := soc.gpio.t_gpio_port_index'val (port_num);
+
+      -- Do all these GPIOs really belong to the caller ?
+      if not ewok.gpio.belong_to (caller_id, port, unsigned_16 (mask)) then
+         goto ret_denied;
+      end if;
+
+      -- Does &val is in the caller address space ?
+      if not ewok.sanitize.is_word_in_data_region
+               (retval_address, caller_id, mode)
+      then
+         goto ret_denied;
+      end if;
+
+      declare
+         retval : unsigned_32
+            with address => to_address (retval_address);
+      begin
+         -- Only the pins owned by the caller are returned
+         retval := unsigned_32 (ewok.gpio.read_pins (port)) and mask;
+         set_return_value (caller_id, mode, SYS_E_DONE);
+         ewok.tasks.set_state (caller_id, mode, TASK_STATE_RUNNABLE);
+         return;
+      end;
+
+   <<ret_inval>>
+      set_return_value (caller_id, mode, SYS_E_INVAL);
+      ewok.tasks.set_state (caller_id, mode, TASK_STATE_RUNNABLE);
+      return;
+
+   <<ret_denied>>
+      set_return_value (caller_id, mode, SYS_E_DENIED);
+      ewok.tasks.set_state (caller_id, mode, TASK_STATE_RUNNABLE);
+      return;
+   end svc_gpio_get_masked;
+
+
+#if CONFIG_KERNEL_EXTI_TIMESTAMPS
+   -- Read the timestamps of the EXTI events of the given GPIO that have not
+   -- been read yet
+   procedure svc_gpio_exti_timestamps
+     (caller_id   : in     ewok.tasks_shared.t_task_id;
+      params      : in out t_parameters;
+      mode        : in     ewok.tasks_shared.t_task_mode)
+   is
+
+      ref            : ewok.exported.gpios.t_gpio_ref
+         with address => params(1)'address;
+
+      stamps_address : constant system_address := params(2);
+      capacity       : constant unsigned_32    := params(3);
+      count_address  : constant system_address := params(4);
+
+      cfg            : ewok.exported.gpios.t_gpio_config_access;
+
+   begin
+
+      -- Task initialization is complete ?
+      if not is_init_done (caller_id) then
+         goto ret_denied;
+      end if;
+
+      -- Valid t_gpio_ref ?
+      if not ref.pin'valid or not ref.port'valid then
+         goto ret_inval;
+      end if;
+
+      -- Does that GPIO really belongs to the caller ?
+      if not ewok.gpio.belong_to (caller_id, ref) then
+         goto ret_denied;
+      end if;
+
+      cfg := ewok.gpio.get_config (ref);
+
+      -- Does that GPIO has an EXTI line ?
+      if cfg.all.exti_trigger = GPIO_EXTI_TRIGGER_NONE then
+         goto ret_inval;
+      end if;
+
+      if capacity = 0 or capacity > ewok.exti.EXTI_TIMESTAMPS_DEPTH then
+         goto ret_inval;
+      end if;
+
+      -- Are the timestamps buffer and &count in the caller address space ?
+      if not ewok.sanitize.is_range_in_data_region
+               (stamps_address, capacity * 4, caller_id, mode)
+         or
+         not ewok.sanitize.is_word_in_data_region
+               (count_address, caller_id, mode)
+      then
+         goto ret_denied;
+      end if;
+
+      declare
+         stamps : ewok.exti.t_timestamp_list (1 .. capacity)
+            with address => to_address (stamps_address);
+         count  : unsigned_32
+            with address => to_address (count_address);
+      begin
+         ewok.exti.get_timestamps (ref, stamps, count);
+      end;
+
+      set_return_value (caller_id, mode, SYS_E_DONE);
+      ewok.tasks.set_state (caller_id, mode, TASK_STATE_RUNNABLE);
+      return;
+
+   <<ret_inval>>
+      set_return_value (caller_id, mode, SYS_E_INVAL);
+      ewok.tasks.set_state (caller_id, mode, TASK_STATE_RUNNABLE);
+      return;
+
+   <<ret_denied>>
+      set_return_value (caller_id, mode, SYS_E_DENIED);
+      ewok.tasks.set_state (caller_id, mode, TASK_STATE_RUNNABLE);
+      return;
+   end svc_gpio_exti_timestamps;
+#end if;
+
+
 end ewok.syscalls.cfg.gpio;
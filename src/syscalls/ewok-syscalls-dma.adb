@@ -23,11 +23,12 @@
 with ewok.tasks;        use ewok.tasks;
 with ewok.tasks_shared; use ewok.tasks_shared;
 with ewok.dma_shared;   use ewok.dma_shared;
-with ewok.exported.dma;
+with ewok.exported.dma; use type ewok.exported.dma.t_dma_shm_access;
 with ewok.dma;
 with ewok.perm;
 with ewok.sanitize;
 with ewok.debug;
+with soc.dma.interfaces; use type soc.dma.interfaces.t_mode;
 
 package body ewok.syscalls.dma
    with spark_mode => off
@@ -288,6 +289,7 @@ is
       declare
          new_dma_config : ewok.exported.dma.t_dma_user_config
             with import, address => to_address (new_dma_config_address);
+         dma_config     : ewok.exported.dma.t_dma_user_config;
       begin
          -- Check if the user tried to change the DMA ctrl/channel/stream
          -- parameters
@@ -299,13 +301,24 @@ is
          end if;
 
          -- Ada based sanitation using on types compliance is not easy,
-         -- as only fields marked by config_mask have a real interpretation
-         -- These fields are checked in the dma_sanitize_dma() function call
-         -- bellow
+         -- as only fields marked by config_mask have a real interpretation.
+         -- Other fields are taken from the current configuration of the
+         -- stream, the resulting configuration being checked in the
+         -- dma_sanitize_dma() function call bellow
+         dma_config := new_dma_config;
+         ewok.dma.merge_user_config
+           (dma_config,
+            TSK.tasks_list(caller_id).dma_id(dma_descriptor),
+            config_mask);
+
+         if not dma_config'valid_scalars then
+            pragma DEBUG (debug.log (debug.ERROR, "svc_dma_reconf(): invalid dma_t"));
+            goto ret_inval;
+         end if;
 
          -- Verify DMA configuration transmitted by the user
          if not ewok.dma.sanitize_dma
-                    (new_dma_config, caller_id, config_mask, mode)
+                    (dma_config, caller_id, config_mask, mode)
          then
             pragma DEBUG (debug.log (debug.ERROR, "svc_dma_reconf(): invalid configuration"));
             goto ret_inval;
@@ -313,7 +326,7 @@ is
 
          -- Reconfigure the DMA controller
          ewok.dma.reconfigure_stream
-           (new_dma_config,
+           (dma_config,
             TSK.tasks_list(caller_id).dma_id(dma_descriptor),
             config_mask,
             caller_id,
@@ -425,4 +438,273 @@ is
    end svc_dma_disable;
 
 
+   procedure svc_register_dma_buffer
+     (caller_id   : in     ewok.tasks_shared.t_task_id;
+      params      : in out t_parameters;
+      mode        : in     ewok.tasks_shared.t_task_mode)
+   is
+      base           : constant system_address := params(1);
+      size           : constant unsigned_32    := params(2);
+      access_type    : constant unsigned_32    := params(3);
+      handle_address : constant system_address := params(4);
+      handle         : unsigned_32;
+      ok             : boolean;
+   begin
+
+      -- DMA allowed for that task?
+      if not ewok.perm.ressource_is_granted
+               (ewok.perm.PERM_RES_DEV_DMA, caller_id)
+      then
+         pragma DEBUG (debug.log (debug.ERROR, "svc_register_dma_buffer(): permission not granted"));
+         goto ret_denied;
+      end if;
+
+      if access_type > ewok.exported.dma.t_dma_shm_access'pos
+                          (ewok.exported.dma.t_dma_shm_access'last)
+      then
+         goto ret_inval;
+      end if;
+
+      -- Does handle_address is in caller's address space ?
+      if not ewok.sanitize.is_word_in_data_region
+                 (handle_address, caller_id, mode)
+      then
+         pragma DEBUG (debug.log (debug.ERROR, "svc_register_dma_buffer(): handle not in task's memory space"));
+         goto ret_inval;
+      end if;
+
+      ewok.dma.register_buffer
+        (caller_id, base, size,
+         ewok.exported.dma.t_dma_shm_access'val (access_type),
+         handle, ok);
+
+      if not ok then
+         pragma DEBUG (debug.log (debug.ERROR, "svc_register_dma_buffer(): invalid buffer"));
+         goto ret_inval;
+      end if;
+
+      declare
+         user_handle : unsigned_32
+            with import, address => to_address (handle_address);
+      begin
+         user_handle := handle;
+      end;
+
+      set_return_value (caller_id, mode, SYS_E_DONE);
+      ewok.tasks.set_state (caller_id, mode, TASK_STATE_RUNNABLE);
+      return;
+
+   <<ret_inval>>
+      set_return_value (caller_id, mode, SYS_E_INVAL);
+      ewok.tasks.set_state (caller_id, mode, TASK_STATE_RUNNABLE);
+      return;
+
+   <<ret_denied>>
+      set_return_value (caller_id, mode, SYS_E_DENIED);
+      ewok.tasks.set_state (caller_id, mode, TASK_STATE_RUNNABLE);
+      return;
+
+   end svc_register_dma_buffer;
+
+
+   -- Fast reconfiguration of the memory side buffer of a DMA stream, using
+   -- a part of a previously registered buffer. Unlike svc_dma_reconf(),
+   -- no memory region needs to be checked.
+   procedure svc_dma_reconf_buffer
+     (caller_id   : in     ewok.tasks_shared.t_task_id;
+      params      : in out t_parameters;
+      mode        : in     ewok.tasks_shared.t_task_mode)
+   is
+      dma_descriptor : constant unsigned_32 := params(1);
+      handle         : constant unsigned_32 := params(2);
+      offset         : constant unsigned_32 := params(3);
+      size           : constant unsigned_32 := params(4);
+      index          : ewok.dma_shared.t_user_dma_index;
+      ok             : boolean;
+   begin
+
+      -- Forbidden before end of task initialization
+      if not is_init_done (caller_id) then
+         goto ret_denied;
+      end if;
+
+      -- Valid DMA descriptor ?
+      if dma_descriptor < TSK.tasks_list(caller_id).dma_id'first or
+         dma_descriptor > TSK.tasks_list(caller_id).num_dma_id
+      then
+         pragma DEBUG (debug.log (debug.ERROR, "svc_dma_reconf_buffer(): invalid descriptor"));
+         goto ret_inval;
+      end if;
+
+      index := TSK.tasks_list(caller_id).dma_id(dma_descriptor);
+      if index = ID_DMA_UNUSED then
+         goto ret_inval;
+      end if;
+
+      -- Valid buffer handle ?
+      if handle not in TSK.tasks_list(caller_id).dma_buffers'range then
+         pragma DEBUG (debug.log (debug.ERROR, "svc_dma_reconf_buffer(): invalid handle"));
+         goto ret_inval;
+      end if;
+
+      declare
+         buffer : ewok.tasks.t_dma_buffer
+            renames TSK.tasks_list(caller_id).dma_buffers(handle);
+      begin
+
+         -- Released or invalidated buffer
+         if buffer.owner_id = ID_UNUSED then
+            goto ret_inval;
+         end if;
+
+         -- The buffer has been checked at registration time. The range
+         -- only needs to be within the buffer (size <= 65535).
+         if size = 0 or size > buffer.size or offset > buffer.size - size
+         then
+            pragma DEBUG (debug.log (debug.ERROR, "svc_dma_reconf_buffer(): range not in buffer"));
+            goto ret_inval;
+         end if;
+
+         -- Memory is the destination of peripheral to memory transfers
+         -- and the source of memory to peripheral ones
+         case ewok.dma.registered_dma(index).config.transfer_dir is
+            when soc.dma.interfaces.PERIPHERAL_TO_MEMORY =>
+               if buffer.access_type /= ewok.exported.dma.SHM_ACCESS_WRITE
+               then
+                  goto ret_denied;
+               end if;
+            when soc.dma.interfaces.MEMORY_TO_PERIPHERAL =>
+               if buffer.access_type /= ewok.exported.dma.SHM_ACCESS_READ
+               then
+                  goto ret_denied;
+               end if;
+            when soc.dma.interfaces.MEMORY_TO_MEMORY     =>
+               goto ret_denied;
+         end case;
+
+         -- The second buffer of the double buffer mode must have the same
+         -- size as the first one
+         if ewok.dma.registered_dma(index).config.mode =
+               soc.dma.interfaces.DOUBLE_BUFFER_MODE
+         then
+            goto ret_denied;
+         end if;
+
+         ewok.dma.reconfigure_buffer
+           (index, buffer.base + offset, unsigned_16 (size), ok);
+
+         if not ok then
+            goto ret_inval;
+         end if;
+      end;
+
+      set_return_value (caller_id, mode, SYS_E_DONE);
+      ewok.tasks.set_state (caller_id, mode, TASK_STATE_RUNNABLE);
+      return;
+
+   <<ret_inval>>
+      set_return_value (caller_id, mode, SYS_E_INVAL);
+      ewok.tasks.set_state (caller_id, mode, TASK_STATE_RUNNABLE);
+      return;
+
+   <<ret_denied>>
+      set_return_value (caller_id, mode, SYS_E_DENIED);
+      ewok.tasks.set_state (caller_id, mode, TASK_STATE_RUNNABLE);
+      return;
+
+   end svc_dma_reconf_buffer;
+
+
+#if CONFIG_KERNEL_DMA_CHAINS
+   procedure svc_dma_chain
+     (caller_id   : in     ewok.tasks_shared.t_task_id;
+      params      : in out t_parameters;
+      mode        : in     ewok.tasks_shared.t_task_mode)
+   is
+      dma_descriptor    : unsigned_32
+         with import, address => params(1)'address;
+      segments_address  : constant system_address := params(2);
+      count             : constant unsigned_32    := params(3);
+      index             : ewok.dma_shared.t_user_dma_index;
+      ok                : boolean;
+   begin
+
+      -- Forbidden before end of task initialization
+      if not is_init_done (caller_id) then
+         goto ret_denied;
+      end if;
+
+      -- Valid DMA descriptor ?
+      if dma_descriptor < TSK.tasks_list(caller_id).dma_id'first or
+         dma_descriptor > TSK.tasks_list(caller_id).num_dma_id
+      then
+         pragma DEBUG (debug.log (debug.ERROR, "svc_dma_chain(): invalid descriptor"));
+         goto ret_inval;
+      end if;
+
+      index := TSK.tasks_list(caller_id).dma_id(dma_descriptor);
+      if index = ID_DMA_UNUSED then
+         goto ret_inval;
+      end if;
+
+      if count > ewok.exported.dma.MAX_DMA_SEGMENTS then
+         pragma DEBUG (debug.log (debug.ERROR, "svc_dma_chain(): too many segments"));
+         goto ret_inval;
+      end if;
+
+      -- Removing the chain
+      if count = 0 then
+         ewok.dma.clear_chain (index);
+         goto ret_done;
+      end if;
+
+      -- Does the segments list is in the caller address space ?
+      if not ewok.sanitize.is_range_in_data_region
+                 (segments_address,
+                  count * ewok.exported.dma.t_dma_segment'size/8,
+                  caller_id,
+                  mode)
+      then
+         pragma DEBUG (debug.log (debug.ERROR, "svc_dma_chain(): segments not in task's memory space"));
+         goto ret_inval;
+      end if;
+
+      declare
+         segments : constant ewok.exported.dma.t_dma_segment_list
+                      (1 .. unsigned_8 (count))
+            with import, address => to_address (segments_address);
+      begin
+
+         if not ewok.dma.sanitize_dma_chain
+                    (index, segments, caller_id, mode)
+         then
+            pragma DEBUG (debug.log (debug.ERROR, "svc_dma_chain(): invalid segments"));
+            goto ret_inval;
+         end if;
+
+         ewok.dma.set_chain (index, segments, ok);
+         if not ok then
+            goto ret_inval;
+         end if;
+      end;
+
+   <<ret_done>>
+      set_return_value (caller_id, mode, SYS_E_DONE);
+      ewok.tasks.set_state (caller_id, mode, TASK_STATE_RUNNABLE);
+      return;
+
+   <<ret_inval>>
+      set_return_value (caller_id, mode, SYS_E_INVAL);
+      ewok.tasks.set_state (caller_id, mode, TASK_STATE_RUNNABLE);
+      return;
+
+   <<ret_denied>>
+      set_return_value (caller_id, mode, SYS_E_DENIED);
+      ewok.tasks.set_state (caller_id, mode, TASK_STATE_RUNNABLE);
+      return;
+
+   end svc_dma_chain;
+#end if;
+
+
 end ewok.syscalls.dma;
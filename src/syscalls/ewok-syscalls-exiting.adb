@@ -27,6 +27,14 @@ with ewok.dma_shared;      use ewok.dma_shared;
 with ewok.devices;
 with ewok.dma;
 with ewok.debug;
+#if CONFIG_KERNEL_ALARM_HRTIMER
+with ewok.hralarm;
+#end if;
+#if CONFIG_KERNEL_ISR_LATENCY_STATS
+with ewok.latency;
+with ewok.exported.latency;
+with soc.interrupts;       use type soc.interrupts.t_interrupt;
+#end if;
 
 package body ewok.syscalls.exiting
    with spark_mode => off
@@ -53,6 +61,23 @@ is
                   (caller_id, TASK_MODE_MAINTHREAD, TASK_STATE_FORCED);
             end if;
          end;
+#end if;
+#if CONFIG_KERNEL_ISR_LATENCY_STATS
+         declare
+            isr_ctx : t_isr_context renames TSK.tasks_list(caller_id).isr_ctx;
+         begin
+            if isr_ctx.lat_interrupt /= soc.interrupts.INT_NONE then
+               ewok.latency.account
+                 (isr_ctx.lat_interrupt,
+                  ewok.exported.latency.LAT_EXECUTED,
+                  isr_ctx.lat_stamp);
+               ewok.latency.account
+                 (isr_ctx.lat_interrupt,
+                  ewok.exported.latency.LAT_TOTAL,
+                  isr_ctx.lat_entry);
+               isr_ctx.lat_interrupt := soc.interrupts.INT_NONE;
+            end if;
+         end;
 #end if;
          ewok.tasks.set_state
             (caller_id, TASK_MODE_ISRTHREAD, TASK_STATE_ISR_DONE);
@@ -72,6 +97,15 @@ is
          --  call (or equivalent)
          --  All waiting events of the softirq input queue for this task should also be
          --  cleaned (they also can be cleaned as they are treated by softirqd)
+
+         -- DMA buffers in the task memory can't be used anymore
+         ewok.dma.release_buffers (caller_id);
+
+#if CONFIG_KERNEL_ALARM_HRTIMER
+         -- Periodic alarms would keep on triggering the task handler
+         ewok.hralarm.unset_alarm (caller_id);
+#end if;
+
          ewok.tasks.set_state
             (caller_id, TASK_MODE_MAINTHREAD, TASK_STATE_FINISHED);
       end if;
@@ -129,6 +163,13 @@ is
          end if;
       end loop;
 
+      -- Invalidate DMA buffers in the task memory
+      ewok.dma.release_buffers (caller_id);
+
+#if CONFIG_KERNEL_ALARM_HRTIMER
+      ewok.hralarm.unset_alarm (caller_id);
+#end if;
+
       -- FIXME: maybe we should also clean IPCs ?
       ewok.tasks.set_state
          (caller_id, TASK_MODE_ISRTHREAD, TASK_STATE_ISR_DONE);
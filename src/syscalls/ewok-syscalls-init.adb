@@ -31,6 +31,7 @@ with ewok.memory;
 with ewok.perm;
 with ewok.sched;
 with ewok.debug;
+with soc.devmap;
 
 package body ewok.syscalls.init
    with spark_mode => off
@@ -115,6 +116,7 @@ is
          if (udev.map_mode = DEV_MAP_AUTO  and udev.size > 0)
             -- ...but no free memory available!
             and then not ewok.memory.device_can_be_mapped
+                           (soc.devmap.find_periph (udev.base_addr, udev.size))
          then
             pragma DEBUG (debug.log (debug.ERROR,
                "svc_register_device(): no free region left to map the device"));
@@ -31,7 +31,13 @@ with ewok.perm;
 with ewok.sleep;
 with ewok.debug;
 with ewok.memory;
-with types.c;           use types.c;
+with ewok.memops;
+#if CONFIG_KERNEL_TRACE_IPC
+with ewok.trace;
+#end if;
+#if CONFIG_KERNEL_BENCH
+with ewok.bench;
+#end if;
 
 
 package body ewok.syscalls.ipc
@@ -127,8 +133,6 @@ is
             with address => to_address (expected_sender_address);
          buf_size          : unsigned_8
             with address => to_address (buf_size_address);
-         buf               : c_buffer (1 .. unsigned_32 (buf_size))
-            with address => to_address (buf_address);
       begin
 
          -- Does &buf is in the caller address space ?
@@ -293,14 +297,23 @@ is
          buf_size := ewok.ipc.ipc_endpoints(ep_id).size;
 
          -- Copying data
-         -- Note: we don't use 'first attribute. By convention, array indexes
-         --       begin with '1' value
-         buf(1 .. unsigned_32 (buf_size)) := ewok.ipc.ipc_endpoints(ep_id).data(1 .. unsigned_32 (buf_size));
+         ewok.memops.copy
+           (buf_address,
+            to_system_address (ewok.ipc.ipc_endpoints(ep_id).data'address),
+            unsigned_32 (buf_size));
 
          -- The EndPoint is ready for another use
          ewok.ipc.ipc_endpoints(ep_id).state := READY;
          ewok.ipc.ipc_endpoints(ep_id).size  := 0;
 
+#if CONFIG_KERNEL_TRACE_IPC
+         ewok.trace.event
+           (ewok.trace.TRACE_IPC_RECV,
+            to_unsigned_32 (caller_id),
+            to_unsigned_32 (id_sender),
+            unsigned_32 (buf_size));
+#end if;
+
          -- Free sender from it's blocking state
          case TSK.get_state (id_sender, TASK_MODE_MAINTHREAD) is
 
@@ -511,7 +524,7 @@ is
       -- Wake up idle receivers
       if ewok.sleep.is_sleeping (id_receiver) then
          ewok.sleep.try_waking_up (id_receiver);
-      elsif receiver_a.all.state = TASK_STATE_IDLE then
+      elsif TSK.tasks_state(id_receiver) = TASK_STATE_IDLE then
          TSK.set_state
            (id_receiver, TASK_MODE_MAINTHREAD, TASK_STATE_RUNNABLE);
       end if;
@@ -552,20 +565,28 @@ is
       ewok.ipc.ipc_endpoints(ep_id).to   := ewok.ipc.to_ext_task_id (id_receiver);
 
       -- We copy the message in the IPC buffer
-      -- Note: we don't use 'first attribute. By convention, array indexes
-      --       begin with '1' value
       ewok.ipc.ipc_endpoints(ep_id).size := buf_size;
 
-      declare
-         buf   : constant c_buffer (1 .. unsigned_32 (buf_size))
-            with import, address => to_address (buf_address);
-      begin
-         ewok.ipc.ipc_endpoints(ep_id).data(1 .. unsigned_32 (buf_size)) := buf(1 .. unsigned_32 (buf_size));
-      end;
+      ewok.memops.copy
+        (to_system_address (ewok.ipc.ipc_endpoints(ep_id).data'address),
+         buf_address,
+         unsigned_32 (buf_size));
 
       -- Adjusting the EndPoint state
       ewok.ipc.ipc_endpoints(ep_id).state := ewok.ipc.WAIT_FOR_RECEIVER;
 
+#if CONFIG_KERNEL_BENCH
+      ewok.bench.start_wakeup (id_receiver, ewok.bench.BENCH_IPC_WAKEUP);
+#end if;
+
+#if CONFIG_KERNEL_TRACE_IPC
+      ewok.trace.event
+        (ewok.trace.TRACE_IPC_SEND,
+         to_unsigned_32 (caller_id),
+         to_unsigned_32 (id_receiver),
+         unsigned_32 (buf_size));
+#end if;
+
       -- If the receiver was blocking, it can be 'freed' from its blocking
       -- state.
       if TSK.get_state (id_receiver, TASK_MODE_MAINTHREAD)
@@ -585,8 +606,8 @@ is
          TSK.set_state
            (caller_id, TASK_MODE_MAINTHREAD, TASK_STATE_IPC_WAIT_ACK);
 #if CONFIG_SCHED_SUPPORT_FIPC
-         if receiver_a.all.state = TASK_STATE_RUNNABLE or
-            receiver_a.all.state = TASK_STATE_IDLE
+         if TSK.tasks_state(id_receiver) = TASK_STATE_RUNNABLE or
+            TSK.tasks_state(id_receiver) = TASK_STATE_IDLE
          then
             TSK.set_state
               (id_receiver, TASK_MODE_MAINTHREAD, TASK_STATE_FORCED);
@@ -0,0 +1,115 @@
+--
+-- Copyright 2018 The wookey project team <wookey@ssi.gouv.fr>
+--   - Ryad     Benadjila
+--   - Arnauld  Michelizza
+--   - Mathieu  Renard
+--   - Philippe Thierry
+--   - Philippe Trebuchet
+--
+-- Licensed under the Apache License, Version 2.0 (the "License");
+-- you may not use this file except in compliance with the License.
+-- You may obtain a copy of the License at
+--
+--     http://www.apache.org/licenses/LICENSE-2.0
+--
+--     Unless required by applicable law or agreed to in writing, software
+--     distributed under the License is distributed on an "AS IS" BASIS,
+--     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+--     See the License for the specific language governing permissions and
+--     limitations under the License.
+--
+--
+
+with ewok.tasks;              use ewok.tasks;
+with ewok.perm;
+with ewok.sanitize;
+with ewok.debug;
+with ewok.interrupts;
+with ewok.latency;
+with ewok.exported.latency;
+with soc.interrupts;
+with soc.nvic;
+
+
+package body ewok.syscalls.latency
+   with spark_mode => off
+is
+
+   procedure svc_isr_latency
+     (caller_id   : in     ewok.tasks_shared.t_task_id;
+      params      : in out t_parameters;
+      mode        : in     ewok.tasks_shared.t_task_mode)
+   is
+      irq            : constant unsigned_32 := params(1);
+      stats_address  : constant system_address := params(2);
+      reset          : constant boolean := params(3) /= 0;
+      intr           : soc.interrupts.t_interrupt;
+   begin
+
+      -- Latencies are measured in cycles
+      if not ewok.perm.ressource_is_granted
+               (ewok.perm.PERM_RES_TIM_GETCYCLE, caller_id)
+      then
+         pragma DEBUG (debug.log (debug.ERROR,
+            ewok.tasks.tasks_list(caller_id).name
+            & ": svc_isr_latency(): permission not granted"));
+         goto ret_denied;
+      end if;
+
+      if irq > unsigned_32 (soc.nvic.t_irq_index'last) then
+         goto ret_inval;
+      end if;
+
+      intr := soc.interrupts.t_interrupt'val (irq + 16);
+
+      -- Only the owner of the interrupt can get its statistics
+      if ewok.interrupts.interrupt_table(intr).task_id /= caller_id then
+         pragma DEBUG (debug.log (debug.ERROR,
+            ewok.tasks.tasks_list(caller_id).name
+            & ": svc_isr_latency(): interrupt not owned by the caller"));
+         goto ret_denied;
+      end if;
+
+      -- Statistics are not read if 'stats' is NULL
+      if stats_address /= 0 then
+         if not ewok.sanitize.is_range_in_data_region
+                 (stats_address,
+                  ewok.exported.latency.t_latency_stats'size / 8,
+                  caller_id,
+                  mode)
+         then
+            pragma DEBUG (debug.log (debug.ERROR,
+               ewok.tasks.tasks_list(caller_id).name
+               & ": svc_isr_latency(): 'stats' parameter not in caller space"));
+            goto ret_inval;
+         end if;
+
+         declare
+            stats : ewok.exported.latency.t_latency_stats
+               with import, address => to_address (stats_address);
+         begin
+            ewok.latency.get_stats (intr, stats);
+         end;
+      end if;
+
+      if reset then
+         ewok.latency.reset_stats (intr);
+      end if;
+
+      set_return_value (caller_id, mode, SYS_E_DONE);
+      ewok.tasks.set_state (caller_id, mode, TASK_STATE_RUNNABLE);
+      return;
+
+   <<ret_inval>>
+      set_return_value (caller_id, mode, SYS_E_INVAL);
+      ewok.tasks.set_state (caller_id, mode, TASK_STATE_RUNNABLE);
+      return;
+
+   <<ret_denied>>
+      set_return_value (caller_id, mode, SYS_E_DENIED);
+      ewok.tasks.set_state (caller_id, mode, TASK_STATE_RUNNABLE);
+      return;
+
+   end svc_isr_latency;
+
+end ewok.syscalls.latency;
@@ -0,0 +1,92 @@
+--
+-- Copyright 2018 The wookey project team <wookey@ssi.gouv.fr>
+--   - Ryad     Benadjila
+--   - Arnauld  Michelizza
+--   - Mathieu  Renard
+--   - Philippe Thierry
+--   - Philippe Trebuchet
+--
+-- Licensed under the Apache License, Version 2.0 (the "License");
+-- you may not use this file except in compliance with the License.
+-- You may obtain a copy of the License at
+--
+--     http://www.apache.org/licenses/LICENSE-2.0
+--
+--     Unless required by applicable law or agreed to in writing, software
+--     distributed under the License is distributed on an "AS IS" BASIS,
+--     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+--     See the License for the specific language governing permissions and
+--     limitations under the License.
+--
+--
+
+
+with ewok.tasks;              use ewok.tasks;
+with ewok.sanitize;
+with ewok.debug;
+with ewok.watermark;
+with ewok.exported.watermark;
+
+
+package body ewok.syscalls.watermark
+   with spark_mode => off
+is
+
+   procedure svc_mem_usage
+     (caller_id   : in     ewok.tasks_shared.t_task_id;
+      params      : in out t_parameters;
+      mode        : in     ewok.tasks_shared.t_task_mode)
+   is
+      usage_address  : constant system_address := params(1);
+      dump           : constant boolean := params(2) /= 0;
+   begin
+
+#if not CONFIG_KERNEL_STACK_WATERMARK_DUMP
+      -- Dumping the usage of the other tasks is a debug feature
+      if dump then
+         pragma DEBUG (debug.log (debug.ERROR,
+            ewok.tasks.tasks_list(caller_id).name
+            & ": svc_mem_usage(): dump not allowed"));
+         set_return_value (caller_id, mode, SYS_E_DENIED);
+         ewok.tasks.set_state (caller_id, mode, TASK_STATE_RUNNABLE);
+         return;
+      end if;
+#end if;
+
+      -- The usage is not read if 'usage' is NULL
+      if usage_address /= 0 then
+         if not ewok.sanitize.is_range_in_data_region
+                 (usage_address,
+                  ewok.exported.watermark.t_mem_usage'size / 8,
+                  caller_id,
+                  mode)
+         then
+            pragma DEBUG (debug.log (debug.ERROR,
+               ewok.tasks.tasks_list(caller_id).name
+               & ": svc_mem_usage(): 'usage' parameter not in caller space"));
+            set_return_value (caller_id, mode, SYS_E_INVAL);
+            ewok.tasks.set_state (caller_id, mode, TASK_STATE_RUNNABLE);
+            return;
+         end if;
+
+         declare
+            usage : ewok.exported.watermark.t_mem_usage
+               with import, address => to_address (usage_address);
+         begin
+            ewok.watermark.get_usage (caller_id, usage);
+         end;
+      end if;
+
+#if CONFIG_KERNEL_STACK_WATERMARK_DUMP
+      -- Only the debug console gets the usage of the other tasks
+      if dump then
+         ewok.watermark.dump;
+      end if;
+#end if;
+
+      set_return_value (caller_id, mode, SYS_E_DONE);
+      ewok.tasks.set_state (caller_id, mode, TASK_STATE_RUNNABLE);
+
+   end svc_mem_usage;
+
+end ewok.syscalls.watermark;
@@ -0,0 +1,79 @@
+#!/usr/bin/env python3
+
+import sys
+import re
+import struct
+
+if len(sys.argv) != 3:
+    print("usage: ", sys.argv[0], "<ewok-syscalls.ads> <bench.bin>\n");
+    print("The statistics can be dumped from gdb with:");
+    print("   dump binary value bench.bin ewok_bench_stats\n");
+    sys.exit(1);
+
+########################################################
+# Statistics layout (see src/ewok-bench.adb)
+########################################################
+
+BENCH_MAGIC = 0x48434E42;
+
+# magic, svc_count, point_count, reserved
+header_fmt  = "<IIII";
+# count, min, max, reserved, total
+stats_fmt   = "<IIIIQ";
+
+# Order of the t_bench_point enumeration
+points = [ "PENDSV", "SYSTICK", "USER_IRQ",
+           "IPC_WAKEUP", "SLEEP_WAKEUP", "ALARM_WAKEUP" ];
+
+
+def get_svc_names(filename):
+    with open(filename, "r") as f:
+        source = f.read();
+
+    m = re.search(r"type\s+t_svc\s+is\s*\(([^)]*)\)", source);
+    if m is None:
+        print("error: t_svc type not found in", filename);
+        sys.exit(1);
+
+    return [ name.strip() for name in m.group(1).split(",") ];
+
+
+def print_stats(name, stats):
+    (count, cmin, cmax, reserved, total) = stats;
+    if count == 0:
+        return;
+    print("%s,%u,%u,%u,%u" % (name, count, cmin, cmax, total // count));
+
+
+svc_names = get_svc_names(sys.argv[1]);
+
+with open(sys.argv[2], "rb") as f:
+    dump = f.read();
+
+header_size = struct.calcsize(header_fmt);
+stats_size  = struct.calcsize(stats_fmt);
+
+(magic, svc_count, point_count, reserved) = \
+    struct.unpack_from(header_fmt, dump, 0);
+
+if magic != BENCH_MAGIC:
+    print("error: invalid statistics magic (0x%08x)" % magic);
+    sys.exit(1);
+if svc_count != len(svc_names) or point_count != len(points):
+    print("error: statistics do not match the kernel sources");
+    sys.exit(1);
+if len(dump) < header_size + (svc_count + point_count) * stats_size:
+    print("error: truncated statistics dump");
+    sys.exit(1);
+
+# One line per measured operation, cycles
+print("name,count,min,max,mean");
+
+offset = header_size;
+for name in svc_names:
+    print_stats(name, struct.unpack_from(stats_fmt, dump, offset));
+    offset += stats_size;
+
+for name in points:
+    print_stats(name, struct.unpack_from(stats_fmt, dump, offset));
+    offset += stats_size;
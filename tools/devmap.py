@@ -9,7 +9,7 @@ if len(sys.argv) != 3:
     print("usage: ", sys.argv[0], "<mode> <filename.json>\n");
     sys.exit(1);
 
-# mode is ADA
+# mode is ADA or REPORT
 mode = sys.argv[1];
 filename = sys.argv[2];
 
@@ -98,6 +98,9 @@ end soc.devmap;
 if re.match(r'^ADA$', mode):
     header = ada_header;
     footer = ada_footer;
+elif re.match(r'^REPORT$', mode):
+    header = "";
+    footer = "";
 else:
     print("Error ! Unsupported mode: %s" % mode);
     exit(1);
@@ -199,9 +202,49 @@ def generate_ada():
         print("%s)" % device["read_only"]);
 #print data;
 
+########################################################
+# Devices sharing a MPU region
+########################################################
+# The kernel (ewok.mpu.allocator) maps a device whose size is a power of 2
+# and with no disabled subregion in a window 8 times its size, the device
+# being one of the window's subregions. Devices of the same size and access
+# type in the same window share a single MPU region.
+
+def coalescing_window(device):
+    size = int(device["size"], 16);
+    mask = int(device["memory_subregion_mask"], 0);
+    addr = int(device["address"], 16);
+    if size < 32 or size > 256 * 1024 * 1024 or (size & (size - 1)) != 0:
+        return None;
+    if mask != 0 or (addr & (size - 1)) != 0:
+        return None;
+    window_size = 8 * size;
+    ro = str(device["read_only"]).lower() == "true";
+    return (addr & ~(window_size - 1), window_size, ro);
+
+def generate_report():
+    windows = collections.OrderedDict();
+    for device in data:
+        if device["type"] != "block":
+            continue;
+        window = coalescing_window(device);
+        if window is None:
+            continue;
+        windows.setdefault(window, []).append(device["name"]);
+
+    print("Devices that can be mapped together in a single MPU region:");
+    for (addr, size, ro), names in windows.items():
+        if len(names) < 2:
+            continue;
+        print("  0x%08x - 0x%08x%s: %s" %
+              (addr, addr + size - 1, " (ro)" if ro else "", ", ".join(names)));
+
+
 print(header);
 
 if re.match(r'^ADA$', mode):
    generate_ada();
+elif re.match(r'^REPORT$', mode):
+   generate_report();
 
 print(footer);
@@ -28,6 +28,8 @@ my    $action   = shift;
 
 my $DEBUG = 0;
 
+my $config = dirname(abs_path($0)) . "/../../../.config";
+
 #
 # main entry point. There is three possible actions:
 # all of them depend on the previously executed gen_app_dummy_ld.pl
@@ -91,7 +93,34 @@ sub main {
             $appid += 1;
         }
 
+        if ($socinfos->{"soc.memorymodel"} =~  m/mpu/) {
+            # the whole footprint of the applications is now known. The
+            # applications flash and RAM regions can be sized accordingly
+            my @names      = map { $_->{'name'} } @applines;
+            my @flash_need = map { $_->{'flash_need'} } @applines;
+            my @ram_need   = map { $_->{'ram_need'} } @applines;
+            my $flash_area = $socinfos->{"memory.flash.\L$mode\E.$component.size"};
+            my $ram_area   = $socinfos->{"memory.ram.$component.size"};
+            my $flash_size = $flash_area;
+            my $ram_size   = $ram_area;
+
+            if (Kconfig::Application::get_kernel_option($config, "KERNEL_APPS_LAYOUT_PACKING") eq "y") {
+                $flash_size = Devmap::Mpu::elf2mem::fit_region_size($flash_area, @flash_need);
+                $ram_size   = Devmap::Mpu::elf2mem::fit_region_size($ram_area, @ram_need);
+            }
+            Devmap::Mpu::elf2mem::set_flash_size($flash_size);
+            Devmap::Mpu::elf2mem::set_ram_size($ram_size);
+
+            Devmap::Mpu::elf2mem::print_waste_report("flash", $flash_size, $flash_area, \@names, \@flash_need);
+            Devmap::Mpu::elf2mem::print_waste_report("RAM", $ram_size, $ram_area, \@names, \@ram_need);
+
+            # the regions size are needed by the membackend action
+            print CFGH "layout.flash.size=$flash_size";
+            print CFGH "layout.ram.size=$ram_size";
+        }
+
         foreach my $appinfo (@applines) {
+            Devmap::Appinfo::map_elf_metainfo($appinfo);
             Ada::Format::format_appinfo_for_cfg(*CFGH, $appinfo);
         }
         close(CFGH);
@@ -156,6 +185,7 @@ sub main {
         #
 
       my $socinfos = Devmap::Appinfo::get_arch_informations();
+      my $layout = get_layout_sizes();
       @applines = @{gen_kernel_membackend()};
       open(KERN_ARCHAPP, ">", dirname(abs_path($0)) . "/../../src/generated/config-memlayout.ads") or die "unable to open output ada file for writing $!";
 
@@ -190,11 +220,11 @@ sub main {
       # let's now, create applications region informations
       print KERN_ARCHAPP "   apps_region : constant t_applications_region := (
       " . Ada::Format::format_ada_hex($socinfos->{"memory.flash.\L$mode\E.apps.addr"}) . ",
-      " . $socinfos->{"memory.flash.\L$mode\E.apps.size"} . ",
-      " . $socinfos->{"memory.flash.\L$mode\E.apps.regionsize"} . ",
+      " . $layout->{'flash_size'} . ",
+      " . Devmap::Mpu::elf2mem::region_size_bits($layout->{'flash_size'}) . ",
       " . Ada::Format::format_ada_hex($socinfos->{"memory.ram.apps.addr"}) . ",
-      " . $socinfos->{"memory.ram.apps.size"} . ",
-      " . $socinfos->{"memory.ram.apps.regionsize"} .");\n";
+      " . $layout->{'ram_size'} . ",
+      " . Devmap::Mpu::elf2mem::region_size_bits($layout->{'ram_size'}) .");\n";
 
 
        print KERN_ARCHAPP "end config.memlayout;";
@@ -227,14 +257,15 @@ sub gen_kernel_membackend {
     my $component = "apps";
 
     my $socinfos = Devmap::Appinfo::get_arch_informations();
+    my $layout = get_layout_sizes();
 
     if ($socinfos->{"soc.memorymodel"} =~  m/mpu/) {
         if ($DEBUG) { print "[+] Handling MPU based memory model"; }
         # initialize memory layout
         Devmap::Mpu::elf2mem::set_numslots($socinfos->{'mpu.subregions_number'});
-        Devmap::Mpu::elf2mem::set_ram_size($socinfos->{"memory.ram.$component.size"});
+        Devmap::Mpu::elf2mem::set_ram_size($layout->{'ram_size'});
         Devmap::Mpu::elf2mem::set_ram_addr($socinfos->{"memory.ram.$component.addr"});
-        Devmap::Mpu::elf2mem::set_flash_size($socinfos->{"memory.flash.\L$mode\E.$component.size"});
+        Devmap::Mpu::elf2mem::set_flash_size($layout->{'flash_size'});
         Devmap::Mpu::elf2mem::set_flash_addr($socinfos->{"memory.flash.\L$mode\E.$component.addr"});
     } elsif ($socinfos->{"soc.memorymodel"} =~  m/mmu/) {
         # initialize memory layout for MMU-based device, setting requested properties
@@ -268,7 +299,8 @@ sub gen_kernel_membackend {
         my $ram_size   = hex($hash{"app${appid}.datasize"}) +
                          hex($hash{"app${appid}.bsssize"}) +
                          hex($hash{"app${appid}.stacksize"}) +
-                         hex($hash{"app${appid}.heapsize"});
+                         hex($hash{"app${appid}.heapsize"}) +
+                         hex($hash{"app${appid}.isrstacksize"});
         my %hash;
         if ($socinfos->{"soc.memorymodel"} =~ m/mpu/) {
             if ($DEBUG) { print "[+] mapping application to MPU based memory model"; }
@@ -340,6 +372,31 @@ sub gen_kernel_generic {
 # Utility functions
 #---
 
+# get back the applications flash and RAM regions size, as calculated by
+# the genappcfg action. Default to the SoC applications areas size.
+#
+# @return:       a hash table holding the flash and RAM regions size
+#
+sub get_layout_sizes {
+    my $socinfos = Devmap::Appinfo::get_arch_informations();
+    my %layout = (
+        flash_size => $socinfos->{"memory.flash.\L$mode\E.apps.size"},
+        ram_size   => $socinfos->{"memory.ram.apps.size"}
+    );
+
+    open(CFGH, "<", "$builddir/apps/layout.\L$mode\E.cfg") or die "unable to open app cfg file for reading: $!";
+    while (<CFGH>)
+    {
+        chomp;
+        if ($_ =~ m/^layout\.(flash|ram)\.size=(\d+)$/) {
+            $layout{"$1_size"} = $2;
+        }
+    }
+    close(CFGH);
+
+    return \%layout;
+}
+
 # given an application, create the arch-generic, application specific layout
 #
 # @argument:     the application ELF file
@@ -363,6 +420,7 @@ sub create_app_generic_info {
         bss_size           => '0',
         heap_size          => '0',
         stack_size         => '0',
+        isr_stack_size     => '0',
         entrypoint         => '0',
         isr_entrypoint     => '0',
         domain             => '0',
@@ -398,6 +456,7 @@ sub create_app_generic_info {
         bss_size           => $hash{"app${id}.bsssize"},
         heap_size          => $hash{"app${id}.heapsize"},
         stack_size         => $hash{"app${id}.stacksize"},
+        isr_stack_size     => $hash{"app${id}.isrstacksize"},
         entrypoint         => $hash{"app${id}.entrypoint"},
         isr_entrypoint     => $hash{"app${id}.isr_entrypoint"},
         domain             => $hash{"app${id}.domain"},
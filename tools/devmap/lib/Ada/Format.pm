@@ -56,6 +56,7 @@ sub format_appinfo_for_kernel {
          %s,        -- .bss section size
          %s,        -- heap size
          %s,        -- stack size
+         %s,        -- ISR stack size
          %s,        -- entrypoint offset in .text
          %s,        -- isr entrypoint offset in .text
          %s,        -- task domain
@@ -66,7 +67,8 @@ sub format_appinfo_for_kernel {
     format_ada_hex($appinfo->{'got_size'}), format_ada_hex($appinfo->{'data_offset'}),
     format_ada_hex($appinfo->{'data_flash_offset'}),
     format_ada_hex($appinfo->{'data_size'}), format_ada_hex($appinfo->{'bss_size'}),
-    format_ada_hex($appinfo->{'heap_size'}), format_ada_hex($appinfo->{'stack_size'}), 
+    format_ada_hex($appinfo->{'heap_size'}), format_ada_hex($appinfo->{'stack_size'}),
+    format_ada_hex($appinfo->{'isr_stack_size'}),
     format_ada_hex($appinfo->{'entrypoint'}), format_ada_hex($appinfo->{'isr_entrypoint'})
       , $domain, $prio);
 
@@ -142,6 +144,7 @@ sub format_appinfo_for_cfg {
     print FH "app$id.bsssize=$appinfo->{'bss_size'}";
     print FH "app$id.stacksize=$appinfo->{'stack_size'}";
     print FH "app$id.heapsize=$appinfo->{'heap_size'}";
+    print FH "app$id.isrstacksize=$appinfo->{'isr_stack_size'}";
     print FH "app$id.entrypoint=$appinfo->{'entrypoint'}";
     print FH "app$id.isr_entrypoint=$appinfo->{'isr_entrypoint'}";
     print FH "app$id.domain=$appinfo->{'domain'}";
@@ -191,38 +191,66 @@ sub dump_elf_metainfo {
     hex($appinfo{'data_size'}) + hex($appinfo{'got_size'}) +
         hex($appinfo{'rodata_size'}) + hex($appinfo{'vdso_size'});
 
+    # when the kernel is configured with per-task ISR stacks, the task ISR
+    # stack is carved out of its RAM slots, just after the heap
+    my $config = dirname(abs_path($0)) . "/../../../.config";
+    my $appcfginfo = Kconfig::Application::dump_application_config($config, $appprefix);
+
+    $appinfo{'isr_stack_size'} = 0;
+    if (Kconfig::Application::get_kernel_option($config, "KERNEL_ISR_PER_TASK_STACK") eq "y") {
+        my $isr_stack_size = $appcfginfo->{'isr_stacksize'};
+        if (not defined $isr_stack_size or $isr_stack_size eq "") {
+            $isr_stack_size = Kconfig::Application::get_kernel_option($config, "KERNEL_ISR_STACK_SIZE");
+        }
+        # Kconfig int options are decimal, hex ones are 0x prefixed
+        $isr_stack_size = ($isr_stack_size =~ /^0x/i) ?
+            oct($isr_stack_size) : int($isr_stack_size);
+        # stack pointer must be 8 bytes aligned (AAPCS)
+        $appinfo{'isr_stack_size'} = sprintf("0x%x", ($isr_stack_size + 7) & ~7);
+    }
+
     my $app_ram_size   = hex($appinfo{'data_size'}) +
     hex($appinfo{'bss_size'}) +
     hex($appinfo{'stack_size'}) +
-    hex($appinfo{'heap_size'});
-
-    my $app_name = $appinfo{'name'};
-    my $app_id = $appinfo{'id'};
-    # 4) Now that the application constraints in term of memory footprint are
-    #    knwon, let's map it to the SoC memory
-    my %app_memorymap = Devmap::Mpu::elf2mem::map_application($app_flash_size, $app_ram_size, $app_name, $app_id);
-
-    # 5) the memory mapper has returned informations about. Here, this information is calculated in offset
-    #    starting with the begining of the user flash/ram region of the current session
-    $appinfo{'text_offset'} = hex($app_memorymap{'flash_slot_addr'}) - hex($socinfos->{"memory.flash.\L$mode\E.\L$component\E.addr"});
-    $appinfo{'text_addr'} = $app_memorymap{'flash_slot_addr'};
-    $appinfo{'data_addr'} = sprintf("0x%x", (hex($appinfo{'data_addr'}) - hex($socinfos->{"memory.flash.base"})) + hex($app_memorymap{'flash_slot_addr'}));
-    $appinfo{'data_flash_offset'} = sprintf("0x%x", (hex($appinfo{'data_addr'}) - hex($socinfos->{"memory.flash.\L$mode\E.\L$component\E.addr"})));
-    $appinfo{'data_offset'} = hex($app_memorymap{'ram_slot_addr'}) - hex($socinfos->{"memory.ram.\L$component\E.addr"});
-
+    hex($appinfo{'heap_size'}) +
+    hex($appinfo{'isr_stack_size'});
 
-    # 6) now get back .config info for app
+    $appinfo{'flash_need'} = $app_flash_size;
+    $appinfo{'ram_need'} = $app_ram_size;
 
-    my $appcfginfo = Kconfig::Application::dump_application_config(dirname(abs_path($0)) . "/../../../.config", $appprefix);
+    # 4) now get back .config info for app
 
     $appinfo{'domain'} = $appcfginfo->{'domain'};
     $appinfo{'prio'} = $appcfginfo->{'prio'};
 
     # push the hashtable for higher level treatment (including Ada file generation) into an
-    # applications list
+    # applications list. The application is mapped later, by map_elf_metainfo(), once the
+    # memory footprint of every application is known
     return \%appinfo;
 }
 
+################################################################
+# Map an application previously dumped by dump_elf_metainfo()
+# to the SoC memory and update its informations accordingly
+#
+sub map_elf_metainfo {
+    my ($appinfo) = @_;
+
+    # 1) Now that the application constraints in term of memory footprint are
+    #    knwon, let's map it to the SoC memory
+    my %app_memorymap = Devmap::Mpu::elf2mem::map_application($appinfo->{'flash_need'}, $appinfo->{'ram_need'}, $appinfo->{'name'}, $appinfo->{'id'});
+
+    # 2) the memory mapper has returned informations about. Here, this information is calculated in offset
+    #    starting with the begining of the user flash/ram region of the current session
+    $appinfo->{'text_offset'} = hex($app_memorymap{'flash_slot_addr'}) - hex($socinfos->{"memory.flash.\L$mode\E.\L$component\E.addr"});
+    $appinfo->{'text_addr'} = $app_memorymap{'flash_slot_addr'};
+    $appinfo->{'data_addr'} = sprintf("0x%x", (hex($appinfo->{'data_addr'}) - hex($socinfos->{"memory.flash.base"})) + hex($app_memorymap{'flash_slot_addr'}));
+    $appinfo->{'data_flash_offset'} = sprintf("0x%x", (hex($appinfo->{'data_addr'}) - hex($socinfos->{"memory.flash.\L$mode\E.\L$component\E.addr"})));
+    $appinfo->{'data_offset'} = hex($app_memorymap{'ram_slot_addr'}) - hex($socinfos->{"memory.ram.\L$component\E.addr"});
+
+    return $appinfo;
+}
+
 
 1;
 
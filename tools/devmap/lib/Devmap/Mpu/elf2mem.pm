@@ -4,7 +4,7 @@ use warnings;
 
 use Exporter qw(import);
 
-our @EXPORT_OK = qw(set_numslots set_ram_size set_flash_size map_application);
+our @EXPORT_OK = qw(set_numslots set_ram_size set_flash_size map_application fit_region_size region_size_bits print_waste_report);
 
 my $numslot = 0;
 my $ramsize = 0;
@@ -82,5 +82,74 @@ sub map_application {
     return %appslotting;
 }
 
+# number of slots (subregions) needed by an application. An application
+# always consumes at least one slot
+sub slots_needed {
+    my ($app_size, $slot_size) = @_;
+    my $slots = int(($app_size + $slot_size - 1) / $slot_size);
+    return ($slots < 1) ? 1 : $slots;
+}
+
+# Layout optimizer. The applications flash (or RAM) region is splitted in
+# $numslot subregions of the same size, each application consuming a set of
+# contiguous subregions. The task ordering has no effect on the number of
+# consumed slots: the only free parameter is the region size (a power of 2,
+# aligned on its size, holding at most the whole SoC applications area).
+# Here we look for the smallest region in which all the applications fit,
+# minimizing the wasted space at the end of each application slots.
+# Smaller regions are always aligned as the applications area is.
+# Subregions are not supported by the MPU for regions smaller than 256 bytes.
+sub fit_region_size {
+    my ($area_size, @app_sizes) = @_;
+    my $best = $area_size;
+    my $size = $area_size / 2;
+
+    while ($size >= 256) {
+        my $slots = 0;
+        foreach my $app_size (@app_sizes) {
+            $slots += slots_needed($app_size, $size / $numslot);
+        }
+        # if the applications don't fit, they don't fit in smaller regions
+        last if ($slots > $numslot);
+        $best = $size;
+        $size /= 2;
+    }
+    return $best;
+}
+
+# MPU bitfield region size info (2^(bits + 1) bytes) of a region
+sub region_size_bits {
+    my ($size) = @_;
+    my $bits = -1;
+    while ($size > 1) {
+        $size /= 2;
+        $bits += 1;
+    }
+    return $bits;
+}
+
+# print the slots consumed and the space wasted by each application in a
+# region
+sub print_waste_report {
+    my ($kind, $region_size, $area_size, $names, $app_sizes) = @_;
+    my $slot_size = $region_size / $numslot;
+    my $total_slots = 0;
+    my $total_waste = 0;
+
+    printf("---> %s layout: region size 0x%x (slot size 0x%x), applications area size 0x%x\n",
+        $kind, $region_size, $slot_size, $area_size);
+    for my $i (0 .. $#{$app_sizes}) {
+        my $slots = slots_needed($app_sizes->[$i], $slot_size);
+        my $waste = ($slots * $slot_size) - $app_sizes->[$i];
+        printf("     %-16s size: 0x%08x, slots: %d, wasted: 0x%08x\n",
+            $names->[$i], $app_sizes->[$i], $slots, $waste);
+        $total_slots += $slots;
+        $total_waste += $waste;
+    }
+    printf("     total wasted: 0x%08x, free slots: %d (0x%08x), unused area: 0x%08x\n",
+        $total_waste, $numslot - $total_slots,
+        ($numslot - $total_slots) * $slot_size, $area_size - $region_size);
+}
+
 
 1;
@@ -35,6 +35,26 @@ sub dump_application_config {
     return \%hash;
 }
 
+# get back a kernel option value from the given config file. Return
+# an empty string if the option is not set
+sub get_kernel_option {
+    my ($config, $option) = @_;
+    my $val = "";
+
+    open(CONFIG, "<", $config) or die "unable to open config file: $!";
+    while (<CONFIG>)
+    {
+        chomp;
+        if ($_ =~ m/^CONFIG_${option}=(.+)/) {
+            $val = $1;
+            last;
+        }
+    }
+    close(CONFIG);
+
+    return $val;
+}
+
 1;
 
 __END__
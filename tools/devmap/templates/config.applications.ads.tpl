@@ -58,6 +58,8 @@ package config.applications is
       heap_size         : t_application_data_size;
       -- Requested stack size
       stack_size        : t_application_data_size;
+      -- ISR stack size (0 when the ISR stack is shared by all tasks)
+      isr_stack_size    : t_application_data_size;
       -- Entrypoint offset, starting at application text start addr
       entrypoint_offset : t_memory_offset;
       -- Isr_entrypoint offset, starting at  application text start addr
@@ -0,0 +1,141 @@
+#!/usr/bin/env python3
+
+import sys
+import json, collections
+import re
+import struct
+
+if len(sys.argv) != 3 and len(sys.argv) != 4:
+    print("usage: ", sys.argv[0], "TABLE <ewok-trace.ads>\n");
+    print("       ", sys.argv[0], "DECODE <trace_events.json> <trace.bin>\n");
+    print("The trace buffer can be dumped from gdb with:");
+    print("   dump binary value trace.bin ewok_trace_buffer\n");
+    sys.exit(1);
+
+# mode is TABLE or DECODE
+mode = sys.argv[1];
+
+########################################################
+# Trace buffer layout (see src/ewok-trace.adb)
+########################################################
+
+TRACE_MAGIC = 0x45435254;
+
+# magic, count, size
+header_fmt  = "<III";
+# stamp, event, reserved, arg1, arg2, arg3
+record_fmt  = "<IHHIII";
+
+# Arguments that are task identifiers (ewok.tasks_shared.t_task_id)
+task_args = [ "task", "old_task", "new_task", "sender", "receiver" ];
+
+task_names = [ "UNUSED", "APP1", "APP2", "APP3", "APP4", "APP5", "APP6",
+               "APP7", "SOFTIRQ", "KERNEL" ];
+
+task_modes = [ "MAINTHREAD", "ISRTHREAD" ];
+
+
+########################################################
+# Generating the event table from the Ada enumeration
+########################################################
+
+def gen_table(filename):
+    events = collections.OrderedDict();
+
+    with open(filename, "r") as f:
+        source = f.read();
+
+    # enumeration literals, with their arguments in the comment
+    for m in re.finditer(r"(TRACE_\w+)\)?,?\s*--\s*([\w, ]*)\n", source):
+        args = [ a.strip() for a in m.group(2).split(",") if a.strip() != "" ];
+        events[m.group(1)] = { "args": args };
+
+    # representation clause
+    for m in re.finditer(r"(TRACE_\w+)\s*=>\s*16#([0-9A-Fa-f_]+)#", source):
+        if m.group(1) not in events:
+            print("error: no arguments description for", m.group(1));
+            sys.exit(1);
+        events[m.group(1)]["id"] = int(m.group(2).replace("_", ""), 16);
+
+    table = collections.OrderedDict();
+    for name, ev in events.items():
+        if "id" not in ev:
+            print("error: no event ID for", name);
+            sys.exit(1);
+        table["0x%04x" % ev["id"]] = { "name": name, "args": ev["args"] };
+
+    print(json.dumps(table, indent=4));
+
+
+########################################################
+# Decoding a dump of the trace buffer
+########################################################
+
+def format_arg(name, value):
+    if name in task_args and value < len(task_names):
+        return "%s=%s" % (name, task_names[value]);
+    if name == "new_mode" and value < len(task_modes):
+        return "%s=%s" % (name, task_modes[value]);
+    return "%s=0x%x" % (name, value);
+
+def decode(tablename, dumpname):
+    with open(tablename, "r") as f:
+        table = json.load(f);
+
+    with open(dumpname, "rb") as f:
+        dump = f.read();
+
+    header_size = struct.calcsize(header_fmt);
+    record_size = struct.calcsize(record_fmt);
+
+    (magic, count, size) = struct.unpack_from(header_fmt, dump, 0);
+    if magic != TRACE_MAGIC:
+        print("error: invalid trace buffer magic (0x%08x)" % magic);
+        sys.exit(1);
+    if len(dump) < header_size + size * record_size:
+        print("error: truncated trace buffer dump");
+        sys.exit(1);
+
+    # Once the ring has wrapped, the oldest record is the next one to be
+    # overwritten
+    if count > size:
+        print("# %d events recorded, %d lost" % (count, count - size));
+        first = count % size;
+        nb    = size;
+    else:
+        print("# %d events recorded" % count);
+        first = 0;
+        nb    = count;
+
+    previous = None;
+    for i in range(nb):
+        offset = header_size + ((first + i) % size) * record_size;
+        (stamp, event, reserved, a1, a2, a3) = \
+            struct.unpack_from(record_fmt, dump, offset);
+
+        # DWT cycle counter wraps on 32 bits
+        delta = 0 if previous is None else (stamp - previous) & 0xffffffff;
+        previous = stamp;
+
+        key = "0x%04x" % event;
+        if key in table:
+            name = table[key]["name"];
+            args = [ format_arg(n, v)
+                     for (n, v) in zip(table[key]["args"], (a1, a2, a3)) ];
+        else:
+            name = "UNKNOWN_" + key;
+            args = [ "0x%x" % a1, "0x%x" % a2, "0x%x" % a3 ];
+
+        print("%10u +%-10u %-20s %s" % (stamp, delta, name, " ".join(args)));
+
+
+if mode == "TABLE":
+    gen_table(sys.argv[2]);
+elif mode == "DECODE":
+    if len(sys.argv) != 4:
+        print("usage: ", sys.argv[0], "DECODE <trace_events.json> <trace.bin>\n");
+        sys.exit(1);
+    decode(sys.argv[2], sys.argv[3]);
+else:
+    print("unknown mode", mode);
+    sys.exit(1);